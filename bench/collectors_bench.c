@@ -0,0 +1,314 @@
+// 采集函数基准：在录制的 /proc 样本、按规模生成的 /proc 和本机 /proc 上运行每个采集函数
+// 报告每次调用的耗时（ns/op）以及内存分配次数和字节数（包括 libc 内部的 fopen/opendir 分配）
+// 磁盘统计对 mounts 中的挂载点调用 statvfs，样本和合成 /proc 的挂载点位于各自的 rootfs 目录下，不读取本机的文件系统
+// 用法：make bench-collectors SOCKETS=10000 INTERFACES=64 PIDS=2000
+//      ./bench/collectors_bench [-f 样本目录] [-r 样本 rootfs] [-s 连接数] [-i 网卡数] [-p 进程数] [-t 每项秒数]
+#define _GNU_SOURCE
+#include <ftw.h>
+
+#define main zsan_main
+#include "../zsan.c"
+#undef main
+
+// 替换 malloc 系列函数统计分配次数，实际分配交给 glibc
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static int g_counting = 0;
+static unsigned long long g_alloc_count = 0;
+static unsigned long long g_alloc_bytes = 0;
+
+void *malloc(size_t size) {
+    if (g_counting) {
+        g_alloc_count++;
+        g_alloc_bytes += size;
+    }
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    if (g_counting) {
+        g_alloc_count++;
+        g_alloc_bytes += nmemb * size;
+    }
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (g_counting) {
+        g_alloc_count++;
+        g_alloc_bytes += size;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+// 基准项：每个采集函数包装成无参调用，结果写入 sink 防止被优化掉
+static volatile unsigned long g_sink;
+static SystemInfo g_info;
+
+static void bench_traffic(void) {
+    unsigned long tx, rx;
+    get_total_traffic(&tx, &rx);
+    g_sink = tx + rx;
+}
+
+static void bench_disk(void) {
+    unsigned long total, avail;
+    get_disk_usage(&total, &avail);
+    g_sink = total + avail;
+}
+
+static void bench_connections(void) {
+    g_sink = get_connection_count();
+}
+
+static void bench_processes(void) {
+    g_sink = get_process_count();
+}
+
+static void bench_meminfo(void) {
+    get_mem_info(&g_info);
+    g_sink = (unsigned long)g_info.mem_total;
+}
+
+static void bench_swap(void) {
+    get_swap_info(&g_info.swap_total, &g_info.swap_free);
+    g_sink = (unsigned long)g_info.swap_total;
+}
+
+static void bench_vmstat(void) {
+    get_vmstat_info(&g_info);
+    g_sink = (unsigned long)g_info.mem_dirty;
+}
+
+static void bench_collect(void) {
+    collect_metrics(&g_info);
+    g_sink = g_info.process_count;
+}
+
+static const struct {
+    const char *name;
+    void (*run)(void);
+} g_benches[] = {
+    {"traffic", bench_traffic},
+    {"disk", bench_disk},
+    {"connections", bench_connections},
+    {"process_count", bench_processes},
+    {"meminfo", bench_meminfo},
+    {"swap", bench_swap},
+    {"vmstat", bench_vmstat},
+    {"collect_metrics", bench_collect},
+};
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// 在指定 /proc 根目录上运行所有基准项，每项运行到超过 seconds 秒（至少 10 次）
+static void run_benches(const char *label, const char *root, const char *host_root, double seconds) {
+    safe_strncpy(g_proc_root, root, sizeof(g_proc_root));
+    safe_strncpy(g_host_root, host_root, sizeof(g_host_root));
+    // vmstat 的文件描述符是持久的，切换根目录时重新打开
+    if (g_vmstat_fd >= 0) {
+        close(g_vmstat_fd);
+        g_vmstat_fd = -1;
+    }
+
+    for (size_t i = 0; i < sizeof(g_benches) / sizeof(g_benches[0]); i++) {
+        for (int warmup = 0; warmup < 3; warmup++) {
+            g_benches[i].run();
+        }
+
+        unsigned long long ops = 0;
+        g_alloc_count = g_alloc_bytes = 0;
+        double start = now_ns(), elapsed;
+        g_counting = 1;
+        do {
+            g_benches[i].run();
+            ops++;
+            elapsed = now_ns() - start;
+        } while (ops < 10 || elapsed < seconds * 1e9);
+        g_counting = 0;
+
+        printf("%-10s %-16s %10llu %12.0f %10.1f %12.0f\n",
+               label, g_benches[i].name, ops, elapsed / ops,
+               (double)g_alloc_count / ops, (double)g_alloc_bytes / ops);
+    }
+}
+
+static int write_file(const char *root, const char *name, const char *content) {
+    char path[PROC_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    fputs(content, fp);
+    return fclose(fp);
+}
+
+static int copy_file(const char *from_root, const char *to_root, const char *name) {
+    char path[PROC_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", from_root, name);
+    FILE *in = fopen(path, "r");
+    if (!in) return -1;
+    snprintf(path, sizeof(path), "%s/%s", to_root, name);
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        fclose(in);
+        return -1;
+    }
+    char buf[8192];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        fwrite(buf, 1, n, out);
+    }
+    fclose(in);
+    return fclose(out);
+}
+
+// 生成 /proc/net/tcp 格式的文件，每行一个连接
+static int write_sockets(const char *root, const char *name, int count, int ipv6) {
+    char path[PROC_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    fprintf(fp, "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n");
+    for (int i = 0; i < count; i++) {
+        if (ipv6) {
+            fprintf(fp, "%4d: 00000000000000000000000001000000:01BB 0000000000000000FFFF0000%08X:%04X 01 "
+                    "00000000:00000000 00:00000000 00000000     0        0 %d 1 0000000000000000 20 4 30 10 -1\n",
+                    i, (unsigned)(0x0A000000 + i), 1024 + i % 60000, 100000 + i);
+        } else {
+            fprintf(fp, "%4d: 0F00000A:01BB %08X:%04X 01 "
+                    "00000000:00000000 00:00000000 00000000     0        0 %d 1 0000000000000000 20 4 30 10 -1\n",
+                    i, (unsigned)(0x0A000000 + i), 1024 + i % 60000, 100000 + i);
+        }
+    }
+    return fclose(fp);
+}
+
+// 逐级创建目录
+static int mkdir_p(const char *dir) {
+    char path[PROC_PATH_MAX];
+    safe_strncpy(path, dir, sizeof(path));
+    for (char *p = path + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(path, 0755) != 0 && errno != EEXIST) return -1;
+        *p = '/';
+    }
+    return mkdir(path, 0755) != 0 && errno != EEXIST ? -1 : 0;
+}
+
+// 为 mounts 中的每个挂载点在 rootfs 下创建目录
+static int build_rootfs(const char *proc_root, const char *rootfs) {
+    char path[PROC_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/mounts", proc_root);
+    FILE *fp = setmntent(path, "r");
+    if (!fp) return -1;
+    struct mntent *mnt;
+    int result = mkdir_p(rootfs);
+    while (result == 0 && (mnt = getmntent(fp)) != NULL) {
+        snprintf(path, sizeof(path), "%s%s", rootfs, mnt->mnt_dir);
+        result = mkdir_p(path);
+    }
+    endmntent(fp);
+    return result;
+}
+
+// 在 base 下按规模生成 proc 和 rootfs：interfaces 个网卡、sockets 个连接（四分之一为 IPv6）、pids 个进程目录
+// meminfo、vmstat、stat、mounts 从样本目录复制
+static int build_synthetic_root(const char *base, const char *fixture, int sockets, int interfaces, int pids) {
+    char root[256];
+    char path[PROC_PATH_MAX];
+    snprintf(root, sizeof(root), "%s/proc", base);
+    snprintf(path, sizeof(path), "%s/net", root);
+    if (mkdir_p(path) != 0) return -1;
+
+    const char *copied[] = {"meminfo", "vmstat", "stat", "mounts", NULL};
+    for (int i = 0; copied[i] != NULL; i++) {
+        if (copy_file(fixture, root, copied[i]) != 0) return -1;
+    }
+
+    snprintf(path, sizeof(path), "%s/net/dev", root);
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    fprintf(fp, "Inter-|   Receive                                                |  Transmit\n"
+                " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n");
+    for (int i = 0; i < interfaces; i++) {
+        // 一半物理网卡，一半容器网卡（会被过滤）
+        fprintf(fp, "%s%d: %12lu %8d    0    0    0     0          0         0 %12lu %8d    0    0    0     0       0          0\n",
+                i % 2 ? "veth" : "eth", i, 1000000UL * (i + 1), 1000 * (i + 1), 2000000UL * (i + 1), 2000 * (i + 1));
+    }
+    if (fclose(fp) != 0) return -1;
+
+    int ipv6 = sockets / 4;
+    if (write_sockets(root, "net/tcp", sockets - ipv6, 0) != 0) return -1;
+    if (write_sockets(root, "net/tcp6", ipv6, 1) != 0) return -1;
+
+    for (int i = 1; i <= pids; i++) {
+        snprintf(path, sizeof(path), "%s/%d", root, i);
+        if (mkdir(path, 0755) != 0) return -1;
+    }
+    // 非进程目录也会被 readdir 遍历到
+    snprintf(path, sizeof(path), "%s/sys", root);
+    if (mkdir(path, 0755) != 0) return -1;
+    if (write_file(root, "uptime", "86400.00 172800.00\n") != 0) return -1;
+
+    snprintf(path, sizeof(path), "%s/rootfs", base);
+    return build_rootfs(root, path);
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int type, struct FTW *ftw) {
+    (void)sb;
+    (void)type;
+    (void)ftw;
+    return remove(path);
+}
+
+int main(int argc, char *argv[]) {
+    const char *fixture = "bench/fixtures/proc";
+    const char *fixture_rootfs = "bench/fixtures/rootfs";
+    int sockets = 10000, interfaces = 64, pids = 2000;
+    double seconds = 0.3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:r:s:i:p:t:")) != -1) {
+        switch (opt) {
+            case 'f': fixture = optarg; break;
+            case 'r': fixture_rootfs = optarg; break;
+            case 's': sockets = atoi(optarg); break;
+            case 'i': interfaces = atoi(optarg); break;
+            case 'p': pids = atoi(optarg); break;
+            case 't': seconds = atof(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-f fixture_dir] [-r fixture_rootfs] [-s sockets] [-i interfaces] [-p pids] [-t seconds]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    char synthetic[] = "/tmp/zsan-bench-XXXXXX";
+    if (!mkdtemp(synthetic) || build_synthetic_root(synthetic, fixture, sockets, interfaces, pids) != 0) {
+        fprintf(stderr, "Failed to build synthetic /proc in %s: %s\n", synthetic, strerror(errno));
+        return 1;
+    }
+
+    printf("fixture=%s synthetic: sockets=%d interfaces=%d pids=%d\n", fixture, sockets, interfaces, pids);
+    printf("%-10s %-16s %10s %12s %10s %12s\n", "root", "collector", "ops", "ns/op", "allocs/op", "bytes/op");
+    char synthetic_proc[PROC_PATH_MAX], synthetic_rootfs[PROC_PATH_MAX];
+    snprintf(synthetic_proc, sizeof(synthetic_proc), "%s/proc", synthetic);
+    snprintf(synthetic_rootfs, sizeof(synthetic_rootfs), "%s/rootfs", synthetic);
+    run_benches("fixture", fixture, fixture_rootfs, seconds);
+    run_benches("synthetic", synthetic_proc, synthetic_rootfs, seconds);
+    run_benches("live", "/proc", "", seconds);
+
+    nftw(synthetic, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// 本地 D1 替身：通过 python3 的 sqlite3 模块执行 SQL，接口与 Worker 中使用的 D1 API 一致
+// （prepare / bind / run / all / first / batch / exec），BLOB 以数字数组返回
+import { spawn } from 'node:child_process';
+import { createInterface } from 'node:readline';
+
+// 每行一个 JSON 请求：{ statements: [{ sql, params }], script }
+const SERVER = String.raw`
+import base64, json, sqlite3, sys, time
+
+db = sqlite3.connect(sys.argv[1], isolation_level=None)
+db.execute('PRAGMA foreign_keys = ON')
+
+def param(value):
+    if isinstance(value, dict) and '$blob' in value:
+        return base64.b64decode(value['$blob'])
+    return value
+
+def row(cursor, values):
+    return {d[0]: (list(v) if isinstance(v, bytes) else v) for d, v in zip(cursor.description, values)}
+
+for line in sys.stdin:
+    request = json.loads(line)
+    start = time.perf_counter()
+    try:
+        if 'script' in request:
+            db.executescript(request['script'])
+            reply = {'results': []}
+        else:
+            results = []
+            db.execute('BEGIN')
+            try:
+                for statement in request['statements']:
+                    before = db.total_changes
+                    cursor = db.execute(statement['sql'], [param(p) for p in statement['params']])
+                    rows = [row(cursor, r) for r in cursor.fetchall()] if cursor.description else []
+                    results.append({
+                        'results': rows,
+                        'meta': {'changes': db.total_changes - before, 'last_row_id': cursor.lastrowid, 'rows_read': len(rows)}
+                    })
+                db.execute('COMMIT')
+            except Exception:
+                db.execute('ROLLBACK')
+                raise
+            reply = {'results': results}
+    except Exception as error:
+        reply = {'error': str(error)}
+    reply['duration'] = (time.perf_counter() - start) * 1000
+    sys.stdout.write(json.dumps(reply) + '\n')
+    sys.stdout.flush()
+`;
+
+const encodeParam = (value) => {
+    if (value instanceof ArrayBuffer || ArrayBuffer.isView(value)) {
+        const bytes = value instanceof ArrayBuffer ? new Uint8Array(value) : value;
+        return { $blob: Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength).toString('base64') };
+    }
+    return value === undefined ? null : value;
+};
+
+class D1Statement {
+    constructor(db, sql, params = []) {
+        this.db = db;
+        this.sql = sql;
+        this.params = params;
+    }
+
+    bind(...params) {
+        return new D1Statement(this.db, this.sql, params.map(encodeParam));
+    }
+
+    async run() {
+        const [result] = await this.db.batch([this]);
+        return { success: true, ...result };
+    }
+
+    async all() {
+        return this.run();
+    }
+
+    async first(column) {
+        const { results } = await this.run();
+        const row = results[0] || null;
+        return column && row ? row[column] : row;
+    }
+}
+
+export class D1SQLite {
+    constructor(file = ':memory:', python = process.env.PYTHON || 'python3') {
+        this.child = spawn(python, ['-c', SERVER, file], { stdio: ['pipe', 'pipe', 'inherit'] });
+        this.pending = [];
+        this.queries = 0;
+        this.dbTime = 0;
+        createInterface({ input: this.child.stdout }).on('line', line => {
+            const reply = JSON.parse(line);
+            this.dbTime += reply.duration;
+            const { resolve, reject } = this.pending.shift();
+            if (reply.error) reject(new Error(`D1_ERROR: ${reply.error}`)); else resolve(reply);
+        });
+    }
+
+    request(message) {
+        return new Promise((resolve, reject) => {
+            this.pending.push({ resolve, reject });
+            this.child.stdin.write(JSON.stringify(message) + '\n');
+        });
+    }
+
+    prepare(sql) {
+        return new D1Statement(this, sql);
+    }
+
+    // 与 D1 一致：batch 中的语句在同一个事务中执行
+    async batch(statements) {
+        this.queries++;
+        const { results } = await this.request({
+            statements: statements.map(({ sql, params }) => ({ sql, params }))
+        });
+        return results.map(result => ({ success: true, ...result }));
+    }
+
+    async exec(script) {
+        this.queries++;
+        await this.request({ script });
+        return { count: 1 };
+    }
+
+    close() {
+        this.child.stdin.end();
+        return new Promise(resolve => this.child.on('close', resolve));
+    }
+}
@@ -0,0 +1,115 @@
+// 上报接口压测：模拟大量客户端向 Worker 的 POST /status 上报，数据库使用本地 SQLite 替身
+// 每轮每个客户端上报一次，CONCURRENCY 个请求同时进行，报告吞吐量和延迟分位数
+// 用法：node bench/load.bench.mjs [客户端数] [轮数] [并发数] [rows|packed]
+// 压测客户端上报 10 秒间隔，按 machine_id 每分钟限 20 次，轮数超过 20 时多出的请求会返回 429
+import { readFileSync, rmSync } from 'node:fs';
+import { tmpdir } from 'node:os';
+import { join } from 'node:path';
+import worker from '../worker.js';
+import { D1SQLite } from './d1-sqlite.mjs';
+
+const AGENTS = parseInt(process.argv[2]) || 2000;
+const ROUNDS = parseInt(process.argv[3]) || 3;
+const CONCURRENCY = parseInt(process.argv[4]) || 32;
+const STORAGE_MODE = process.argv[5] || 'rows';
+
+const MIGRATIONS = ['0001_initial.sql', '0002_compact_storage.sql', '0003_memory_pressure.sql', '0004_report_interval.sql'];
+const migration = (name) => readFileSync(new URL(`../migrations/${name}`, import.meta.url), 'utf8');
+
+// 与 zsan.c 的 metrics_to_post_data 字段一致
+function agentBody(agent, round) {
+    const fields = {
+        machine_id: `load${String(agent).padStart(28, '0')}`,
+        name: `agent-${agent}`,
+        system: 'Debian GNU/Linux 12 (bookworm)',
+        location: '未知',
+        ip_address: `10.${agent >> 16}.${(agent >> 8) & 255}.${agent & 255}`,
+        uptime: 86400 + round * 10,
+        cpu_percent: (Math.random() * 100).toFixed(2),
+        net_tx: 123456789 + round * 40000 + agent,
+        net_rx: 987654321 + round * 90000 + agent,
+        disks_total_kb: 104857600,
+        disks_avail_kb: 52428800 - round * 4,
+        cpu_num_cores: 4,
+        mem_total: '7936.5',
+        mem_free: (2048 + Math.random() * 100).toFixed(1),
+        mem_used: (4096 + Math.random() * 100).toFixed(1),
+        swap_total: '1024.0',
+        swap_free: '1024.0',
+        process_count: 180 + (round % 7),
+        connection_count: 40 + (round % 11),
+        mem_buff_cache: '1536.0',
+        mem_dirty: (Math.random() * 16).toFixed(1),
+        mem_writeback: '0.0',
+        pgmajfault_rate: (Math.random() * 5).toFixed(2),
+        pswpin_rate: '0.00',
+        pswpout_rate: '0.00',
+        pgscan_direct_rate: '0.00',
+        pgscan_kswapd_rate: (Math.random() * 200).toFixed(2),
+        pgsteal_direct_rate: '0.00',
+        pgsteal_kswapd_rate: (Math.random() * 200).toFixed(2),
+        oom_kill: 0,
+        report_interval: 10
+    };
+    // 客户端以 application/x-www-form-urlencoded 上报
+    return new URLSearchParams(Object.entries(fields).map(([key, value]) => [key, String(value)])).toString();
+}
+
+const percentile = (sorted, p) => sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+
+const file = join(tmpdir(), `zsan-load-${process.pid}.db`);
+rmSync(file, { force: true });
+const db = new D1SQLite(file);
+for (const name of MIGRATIONS) await db.exec(migration(name));
+
+const env = { DB: db, STORAGE_MODE };
+const pending = [];
+const ctx = { waitUntil: (promise) => pending.push(promise) };
+
+// 按轮次排列请求，同一轮内各客户端依次上报
+const total = AGENTS * ROUNDS;
+const latencies = new Float64Array(total);
+const statuses = {};
+let next = 0;
+
+async function client() {
+    while (next < total) {
+        const index = next++;
+        const agent = index % AGENTS;
+        const round = Math.floor(index / AGENTS);
+        const request = new Request('http://bench/status', {
+            method: 'POST',
+            headers: {
+                'Content-Type': 'application/x-www-form-urlencoded',
+                // 每个客户端一个出口 IP，不触发按 IP 的限流
+                'CF-Connecting-IP': `10.${agent >> 16}.${(agent >> 8) & 255}.${agent & 255}`
+            },
+            body: agentBody(agent, round)
+        });
+        const start = performance.now();
+        const response = await worker.fetch(request, env, ctx);
+        await response.arrayBuffer();
+        latencies[index] = performance.now() - start;
+        statuses[response.status] = (statuses[response.status] || 0) + 1;
+    }
+}
+
+// Worker 每个请求都会打印日志，压测期间关闭
+console.log = () => {};
+console.info(`agents=${AGENTS} rounds=${ROUNDS} concurrency=${CONCURRENCY} storage=${STORAGE_MODE}`);
+
+const start = performance.now();
+await Promise.all(Array.from({ length: CONCURRENCY }, client));
+const elapsed = performance.now() - start;
+await Promise.allSettled(pending);
+
+const sorted = Array.from(latencies).sort((a, b) => a - b);
+console.info(`requests     ${total}`);
+console.info(`status       ${Object.entries(statuses).map(([status, count]) => `${status}=${count}`).join(' ')}`);
+console.info(`throughput   ${(total / elapsed * 1000).toFixed(1)} req/s`);
+console.info(`latency ms   p50=${percentile(sorted, 0.5).toFixed(2)} p95=${percentile(sorted, 0.95).toFixed(2)}` +
+    ` p99=${percentile(sorted, 0.99).toFixed(2)} max=${sorted[sorted.length - 1].toFixed(2)}`);
+console.info(`db           ${(db.queries / total).toFixed(2)} batches/req, ${(db.dbTime / total).toFixed(3)} ms/req`);
+
+await db.close();
+rmSync(file, { force: true });
@@ -0,0 +1,129 @@
+// 限流器微基准：100k 个不同的键轮流请求，对比旧的时间戳数组实现
+// 另模拟单个 IP 轮换 machine_id 上报，对比只按 machine_id 限流和先按 IP 再按 machine_id 限流，
+// 以及固定容量和按上报间隔确定容量时不同间隔客户端的放行情况
+// 用法：node --expose-gc bench/ratelimit.bench.mjs [键数量] [轮数]
+import { RateLimiter } from '../worker.js';
+
+const INGEST = { WINDOW_SIZE: 60, MAX_REQUESTS: 20, BURST_FACTOR: 2 };
+const INGEST_IP = { WINDOW_SIZE: 60, MAX_REQUESTS: 600 };
+
+const KEYS = parseInt(process.argv[2]) || 100000;
+const ROUNDS = parseInt(process.argv[3]) || 10;
+const LIMIT = { WINDOW_SIZE: 60, MAX_REQUESTS: 100 };
+
+// 旧实现：每个 IP 一个时间戳数组，每次请求过滤整个数组，从不淘汰
+class LegacyRateLimiter {
+    constructor() {
+        this.requests = new Map();
+    }
+
+    take(ip, now) {
+        const windowStart = now - (LIMIT.WINDOW_SIZE * 1000);
+        if (this.requests.has(ip)) {
+            this.requests.get(ip).timestamps = this.requests.get(ip).timestamps.filter(
+                time => time > windowStart
+            );
+        }
+        const record = this.requests.get(ip) || { timestamps: [] };
+        if (record.timestamps.length >= LIMIT.MAX_REQUESTS) {
+            return false;
+        }
+        record.timestamps.push(now);
+        this.requests.set(ip, record);
+        return true;
+    }
+}
+
+// 定长数组分配在堆外，一并计入
+const heapUsed = () => {
+    if (global.gc) global.gc();
+    const { heapUsed, arrayBuffers } = process.memoryUsage();
+    return heapUsed + arrayBuffers;
+};
+
+const keys = Array.from({ length: KEYS }, (_, i) => `10.${(i >> 16) & 255}.${(i >> 8) & 255}.${i & 255}`);
+
+function run(name, createLimiter) {
+    const heapBefore = heapUsed();
+    const limiter = createLimiter();
+    let now = Date.now();
+    let allowed = 0;
+    const start = process.hrtime.bigint();
+    for (let round = 0; round < ROUNDS; round++) {
+        for (let i = 0; i < KEYS; i++) {
+            if (limiter.take(keys[i], now)) allowed++;
+            now += 0.01;
+        }
+    }
+    const elapsed = Number(process.hrtime.bigint() - start);
+    const ops = KEYS * ROUNDS;
+    const heapDelta = (heapUsed() - heapBefore) / 1024 / 1024;
+    // 单个热点键连续请求，验证窗口内只放行 MAX_REQUESTS 次
+    let hot = 0;
+    for (let i = 0; i < LIMIT.MAX_REQUESTS * 2; i++) {
+        if (limiter.take('hot', now)) hot++;
+    }
+    console.log(`${name.padEnd(24)} ${(elapsed / ops).toFixed(1).padStart(8)} ns/op  ` +
+        `${heapDelta.toFixed(1).padStart(7)} MiB heap  allowed ${allowed}/${ops}  hot ${hot}/${LIMIT.MAX_REQUESTS * 2}`);
+}
+
+console.log(`keys=${KEYS} rounds=${ROUNDS}${global.gc ? '' : ' (run with --expose-gc for accurate heap numbers)'}`);
+run('token bucket (10k LRU)', () => new RateLimiter(LIMIT, 10000));
+run(`token bucket (${KEYS / 1000}k)`, () => new RateLimiter(LIMIT, KEYS));
+run('legacy (timestamps)', () => new LegacyRateLimiter());
+
+// 单个 IP、大量 machine_id：5 分钟内 1000 台正常服务器（各自的 IP）每 10 秒上报一次，
+// 同时一个 IP 每毫秒用新的 machine_id 上报一次；统计攻击请求的放行数和被挤出限流器的正常服务器数
+function rotatingIds(name, withIpLimit) {
+    const AGENTS = 1000;
+    const DURATION = 5 * 60 * 1000;
+    const byMachine = new RateLimiter(INGEST, 10000);
+    const byIp = new RateLimiter(INGEST_IP, 10000);
+    const allow = (ip, machineId, now) =>
+        (!withIpLimit || byIp.take(ip, now)) && byMachine.take(`machine:${machineId}`, now);
+
+    let attacker = 0, attackerAllowed = 0, agentAllowed = 0, agentSent = 0;
+    const start = Date.now();
+    for (let t = 0; t < DURATION; t++) {
+        const now = start + t;
+        if (allow('203.0.113.7', `rotating-${attacker++}`, now)) attackerAllowed++;
+        // 正常服务器的上报均匀分布在 10 秒内
+        if (t % 10000 < AGENTS * 10 && (t % 10000) % 10 === 0) {
+            const agent = (t % 10000) / 10;
+            agentSent++;
+            if (allow(keys[agent], `agent-${agent}`, now)) agentAllowed++;
+        }
+    }
+    const evicted = Array.from({ length: AGENTS }, (_, i) => `machine:agent-${i}`)
+        .filter(key => !byMachine.slots.has(key)).length;
+    console.log(`${name.padEnd(24)} attacker allowed ${attackerAllowed}/${attacker}  ` +
+        `agents allowed ${agentAllowed}/${agentSent}  agent buckets evicted ${evicted}/${AGENTS}`);
+}
+
+console.log('one IP, rotating machine_id (5 min, 1000 agents)');
+rotatingIds('machine_id only', false);
+rotatingIds('IP + machine_id', true);
+
+// 按上报间隔确定 machine_id 容量（与 worker.js 的 rateLimits.ingest 一致），
+// 统计 5 分钟内不同间隔的客户端被放行的比例
+function reportIntervals(name, sized) {
+    const DURATION = 5 * 60 * 1000;
+    const capacity = (interval) => sized
+        ? Math.max(INGEST.MAX_REQUESTS, Math.ceil(INGEST.WINDOW_SIZE / interval * INGEST.BURST_FACTOR))
+        : INGEST.MAX_REQUESTS;
+    const results = [1, 2, 5, 10].map(interval => {
+        const limiter = new RateLimiter(INGEST, 16);
+        let sent = 0, allowed = 0;
+        const start = Date.now();
+        for (let t = 0; t < DURATION; t += interval * 1000) {
+            sent++;
+            if (limiter.take(`machine:agent-${interval}`, start + t, capacity(interval))) allowed++;
+        }
+        return `${interval}s ${allowed}/${sent}`;
+    });
+    console.log(`${name.padEnd(24)} ${results.join('  ')}`);
+}
+
+console.log('report interval (5 min, one agent per interval)');
+reportIntervals('fixed 20/min', false);
+reportIntervals('sized by interval', true);
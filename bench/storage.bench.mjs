@@ -0,0 +1,149 @@
+// 存储基准：在本地 SQLite 替身上对比旧表结构、紧凑行存储和 packed 存储
+// 每种模式写入 客户端数 × 轮数 个样本，报告每个保留样本占用的字节数和每次写入更新的 B 树数量
+// 用法：node bench/storage.bench.mjs [客户端数] [轮数]
+import { readFileSync, rmSync } from 'node:fs';
+import { tmpdir } from 'node:os';
+import { join } from 'node:path';
+import worker from '../worker.js';
+import { D1SQLite } from './d1-sqlite.mjs';
+
+const CLIENTS = parseInt(process.argv[2]) || 500;
+const ROUNDS = parseInt(process.argv[3]) || 15;
+const RETENTION = 10;
+
+const migration = (name) => readFileSync(new URL(`../migrations/${name}`, import.meta.url), 'utf8');
+
+// 模拟一台服务器第 round 次上报的表单
+function sampleForm(prefix, client, round) {
+    const form = new FormData();
+    const fields = {
+        machine_id: `${prefix}${String(client).padStart(28, '0')}`,
+        name: `server-${client}`,
+        system: 'Debian GNU/Linux 12 (bookworm)',
+        location: '未知',
+        ip_address: `10.0.${client >> 8}.${client & 255}`,
+        uptime: 86400 + round * 10,
+        cpu_percent: (Math.random() * 100).toFixed(2),
+        net_tx: 123456789 + round * 40000 + client,
+        net_rx: 987654321 + round * 90000 + client,
+        disks_total_kb: 104857600,
+        disks_avail_kb: 52428800 - round * 4,
+        cpu_num_cores: 4,
+        mem_total: '7936.5',
+        mem_free: (2048 + Math.random() * 100).toFixed(1),
+        mem_used: (4096 + Math.random() * 100).toFixed(1),
+        swap_total: '1024.0',
+        swap_free: '1024.0',
+        process_count: 180 + (round % 7),
+        connection_count: 40 + (round % 11),
+        report_interval: 10
+    };
+    for (const [key, value] of Object.entries(fields)) form.append(key, String(value));
+    return form;
+}
+
+// 旧版写入路径：每个样本更新 client、插入包含身份字段的宽行，并按客户端清理
+// （旧版清理语句的子查询实际作用于全表，这里按预期的每客户端保留语义执行）
+async function legacyIngest(db, form) {
+    const get = (key) => form.get(key);
+    const { results } = await db.prepare('SELECT id FROM client WHERE machine_id = ?').bind(get('machine_id')).run();
+    let clientId;
+    if (results[0]) {
+        clientId = results[0].id;
+        await db.prepare('UPDATE client SET name = ? WHERE id = ?').bind(get('name'), clientId).run();
+    } else {
+        const { meta } = await db.prepare('INSERT INTO client (machine_id, name) VALUES (?, ?)')
+            .bind(get('machine_id'), get('name')).run();
+        clientId = meta.last_row_id;
+    }
+    await db.prepare(`
+        INSERT INTO status (
+            client_id, name, system, location, insert_utc_ts,
+            uptime, cpu_percent, net_tx, net_rx, disks_total_kb,
+            disks_avail_kb, cpu_num_cores, mem_total, mem_free,
+            mem_used, swap_total, swap_free, process_count,
+            connection_count, ip_address, country_code
+        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    `).bind(
+        clientId, get('name'), get('system'), get('location'), Math.floor(Date.now() / 1000),
+        parseInt(get('uptime')), parseFloat(get('cpu_percent')), parseInt(get('net_tx')), parseInt(get('net_rx')),
+        parseInt(get('disks_total_kb')), parseInt(get('disks_avail_kb')), parseInt(get('cpu_num_cores')),
+        parseFloat(get('mem_total')), parseFloat(get('mem_free')), parseFloat(get('mem_used')),
+        parseFloat(get('swap_total')), parseFloat(get('swap_free')), parseInt(get('process_count')),
+        parseInt(get('connection_count')), get('ip_address'), 'xx'
+    ).run();
+    await db.prepare(`
+        DELETE FROM status WHERE client_id = ? AND id NOT IN (
+            SELECT id FROM status WHERE client_id = ? ORDER BY insert_utc_ts DESC LIMIT ?
+        )
+    `).bind(clientId, clientId, RETENTION).run();
+}
+
+// 每次写入样本需要更新的 B 树：样本表、其上的索引、触发器写入的表及其索引、AUTOINCREMENT 的 sqlite_sequence
+async function btreesPerSample(db, table) {
+    const { results: objects } = await db.prepare('SELECT type, name, tbl_name, sql FROM sqlite_master').run();
+    const indexesOf = (name) => objects.filter(o => o.type === 'index' && o.tbl_name === name).length;
+    const tables = [table, ...objects
+        .filter(o => o.type === 'trigger' && o.tbl_name === table)
+        .map(o => o.sql.match(/INTO\s+(\w+)/i)[1])];
+    return tables.reduce((sum, name) => {
+        const sql = objects.find(o => o.type === 'table' && o.name === name)?.sql || '';
+        return sum + 1 + indexesOf(name) + (/AUTOINCREMENT/i.test(sql) ? 1 : 0);
+    }, 0);
+}
+
+// 样本相关的表和索引占用的字节数
+async function sampleBytes(db) {
+    const { results } = await db.prepare(`
+        SELECT COALESCE(SUM(d.pgsize), 0) AS bytes
+        FROM dbstat d
+        JOIN sqlite_master m ON m.name = d.name
+        WHERE m.tbl_name IN ('status', 'status_packed', 'latest_status')
+    `).run();
+    return results[0].bytes;
+}
+
+async function run(name, { migrations, table, ingest }) {
+    const file = join(tmpdir(), `zsan-storage-${process.pid}-${name}.db`);
+    rmSync(file, { force: true });
+    const db = new D1SQLite(file);
+    for (const file of migrations) await db.exec(migration(file));
+
+    const start = process.hrtime.bigint();
+    for (let round = 0; round < ROUNDS; round++) {
+        for (let client = 0; client < CLIENTS; client++) {
+            await ingest(db, sampleForm(name.slice(0, 4), client, round));
+        }
+    }
+    const elapsed = Number(process.hrtime.bigint() - start) / 1e6;
+    const samples = CLIENTS * ROUNDS;
+    const retained = CLIENTS * Math.min(ROUNDS, RETENTION);
+    const bytes = await sampleBytes(db);
+    const btrees = await btreesPerSample(db, table);
+
+    console.info(`${name.padEnd(8)} ${String(btrees).padStart(7)}  ${(bytes / retained).toFixed(1).padStart(12)}` +
+        `  ${(db.queries / samples).toFixed(1).padStart(12)}  ${(db.dbTime / samples).toFixed(3).padStart(10)}` +
+        `  ${(elapsed / samples).toFixed(3).padStart(10)}`);
+    await db.close();
+    rmSync(file, { force: true });
+}
+
+const post = (storageMode) => (db, form) => worker.fetch(
+    new Request('http://bench/status', {
+        method: 'POST',
+        headers: { 'CF-Connecting-IP': form.get('ip_address') },
+        body: form
+    }),
+    { DB: db, STORAGE_MODE: storageMode }
+).then(async response => {
+    if (!response.ok) throw new Error(`POST /status failed: ${await response.text()}`);
+});
+
+// Worker 每个请求都会打印日志，基准运行期间关闭
+console.log = () => {};
+console.info(`clients=${CLIENTS} rounds=${ROUNDS} retention=${RETENTION}`);
+console.info('mode      btrees  bytes/sample  queries/post  db ms/post     ms/post');
+
+await run('legacy', { migrations: ['0001_initial.sql'], table: 'status', ingest: legacyIngest });
+await run('rows', { migrations: ['0001_initial.sql', '0002_compact_storage.sql', '0003_memory_pressure.sql', '0004_report_interval.sql'], table: 'status', ingest: post('rows') });
+await run('packed', { migrations: ['0001_initial.sql', '0002_compact_storage.sql', '0003_memory_pressure.sql', '0004_report_interval.sql'], table: 'status_packed', ingest: post('packed') });
@@ -0,0 +1,69 @@
+-- 初始数据库结构（v0.0.2）
+
+CREATE TABLE IF NOT EXISTS client (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    machine_id TEXT NOT NULL UNIQUE,
+    name TEXT
+);
+
+CREATE TABLE IF NOT EXISTS status (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    client_id INTEGER NOT NULL,
+    name TEXT,
+    system TEXT,
+    location TEXT,
+    insert_utc_ts INTEGER NOT NULL,
+    uptime INTEGER,
+    cpu_percent REAL,
+    net_tx INTEGER,
+    net_rx INTEGER,
+    disks_total_kb INTEGER,
+    disks_avail_kb INTEGER,
+    cpu_num_cores INTEGER,
+    mem_total REAL,
+    mem_free REAL,
+    mem_used REAL,
+    swap_total REAL,
+    swap_free REAL,
+    process_count INTEGER,
+    connection_count INTEGER,
+    ip_address TEXT,
+    country_code TEXT,
+    FOREIGN KEY (client_id) REFERENCES client(id)
+);
+
+CREATE TABLE IF NOT EXISTS latest_status (
+    client_id INTEGER PRIMARY KEY,
+    status_id INTEGER,
+    insert_utc_ts INTEGER,
+    ip_address TEXT,
+    country_code TEXT,
+    FOREIGN KEY (client_id) REFERENCES client(id),
+    FOREIGN KEY (status_id) REFERENCES status(id)
+);
+
+CREATE TRIGGER IF NOT EXISTS update_latest_status
+AFTER INSERT ON status
+FOR EACH ROW
+BEGIN
+    INSERT OR REPLACE INTO latest_status (
+        client_id,
+        status_id,
+        insert_utc_ts,
+        ip_address,
+        country_code
+    )
+    VALUES (
+        NEW.client_id,
+        NEW.id,
+        NEW.insert_utc_ts,
+        NEW.ip_address,
+        NEW.country_code
+    );
+END;
+
+CREATE INDEX IF NOT EXISTS idx_client_machine_id ON client(machine_id);
+CREATE INDEX IF NOT EXISTS idx_status_client_id ON status(client_id);
+CREATE INDEX IF NOT EXISTS idx_status_insert_time ON status(insert_utc_ts);
+CREATE INDEX IF NOT EXISTS idx_status_ip_address ON status(ip_address);
+CREATE INDEX IF NOT EXISTS idx_status_country_code ON status(country_code);
@@ -0,0 +1,93 @@
+-- 紧凑存储：身份字段移到 client 表（变化时记录版本），status 只保留数值指标
+-- 在 0001_initial.sql 之后执行一次
+
+-- 1. client 表增加身份字段和版本号
+ALTER TABLE client ADD COLUMN system TEXT;
+ALTER TABLE client ADD COLUMN location TEXT;
+ALTER TABLE client ADD COLUMN ip_address TEXT;
+ALTER TABLE client ADD COLUMN country_code TEXT;
+ALTER TABLE client ADD COLUMN info_version INTEGER NOT NULL DEFAULT 0;
+
+-- 身份字段的历史版本，只在变化时写入
+CREATE TABLE IF NOT EXISTS client_info (
+    client_id INTEGER NOT NULL,
+    version INTEGER NOT NULL,
+    name TEXT,
+    system TEXT,
+    location TEXT,
+    ip_address TEXT,
+    country_code TEXT,
+    valid_from_ts INTEGER NOT NULL,
+    PRIMARY KEY (client_id, version),
+    FOREIGN KEY (client_id) REFERENCES client(id)
+) WITHOUT ROWID;
+
+-- 2. 用每个客户端最新的状态回填身份字段
+UPDATE client SET
+    name = COALESCE((SELECT s.name FROM status s WHERE s.client_id = client.id ORDER BY s.id DESC LIMIT 1), name),
+    system = (SELECT s.system FROM status s WHERE s.client_id = client.id ORDER BY s.id DESC LIMIT 1),
+    location = (SELECT s.location FROM status s WHERE s.client_id = client.id ORDER BY s.id DESC LIMIT 1),
+    ip_address = (SELECT s.ip_address FROM status s WHERE s.client_id = client.id ORDER BY s.id DESC LIMIT 1),
+    country_code = (SELECT s.country_code FROM status s WHERE s.client_id = client.id ORDER BY s.id DESC LIMIT 1),
+    info_version = 1;
+
+INSERT INTO client_info (client_id, version, name, system, location, ip_address, country_code, valid_from_ts)
+SELECT id, 1, name, system, location, ip_address, country_code,
+       COALESCE((SELECT MAX(s.insert_utc_ts) FROM status s WHERE s.client_id = client.id), 0)
+FROM client;
+
+-- 3. latest_status 没有查询使用，去掉它和每次插入都会触发的写入
+DROP TRIGGER IF EXISTS update_latest_status;
+DROP TABLE IF EXISTS latest_status;
+
+-- 4. 重建 status 表，只保留数值指标；不使用 AUTOINCREMENT，避免每次插入都写 sqlite_sequence
+CREATE TABLE status_compact (
+    id INTEGER PRIMARY KEY,
+    client_id INTEGER NOT NULL,
+    insert_utc_ts INTEGER NOT NULL,
+    uptime INTEGER,
+    cpu_percent REAL,
+    net_tx INTEGER,
+    net_rx INTEGER,
+    disks_total_kb INTEGER,
+    disks_avail_kb INTEGER,
+    cpu_num_cores INTEGER,
+    mem_total REAL,
+    mem_free REAL,
+    mem_used REAL,
+    swap_total REAL,
+    swap_free REAL,
+    process_count INTEGER,
+    connection_count INTEGER,
+    FOREIGN KEY (client_id) REFERENCES client(id)
+);
+
+INSERT INTO status_compact (
+    id, client_id, insert_utc_ts, uptime, cpu_percent, net_tx, net_rx,
+    disks_total_kb, disks_avail_kb, cpu_num_cores, mem_total, mem_free,
+    mem_used, swap_total, swap_free, process_count, connection_count
+)
+SELECT
+    id, client_id, insert_utc_ts, uptime, cpu_percent, net_tx, net_rx,
+    disks_total_kb, disks_avail_kb, cpu_num_cores, mem_total, mem_free,
+    mem_used, swap_total, swap_free, process_count, connection_count
+FROM status;
+
+-- 删除旧表会同时删除 idx_status_client_id、idx_status_insert_time、idx_status_ip_address、idx_status_country_code
+DROP TABLE status;
+ALTER TABLE status_compact RENAME TO status;
+
+-- 保留数据和查询最新状态都按客户端和时间访问
+CREATE INDEX IF NOT EXISTS idx_status_client_ts ON status(client_id, insert_utc_ts);
+
+-- machine_id 的 UNIQUE 约束已经自带索引
+DROP INDEX IF EXISTS idx_client_machine_id;
+
+-- 5. packed 存储模式（STORAGE_MODE=packed）：每个客户端一行，最近的样本打包在 data 中
+CREATE TABLE IF NOT EXISTS status_packed (
+    client_id INTEGER PRIMARY KEY,
+    sample_count INTEGER NOT NULL,
+    last_utc_ts INTEGER NOT NULL,
+    data BLOB NOT NULL,
+    FOREIGN KEY (client_id) REFERENCES client(id)
+);
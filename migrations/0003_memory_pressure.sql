@@ -0,0 +1,15 @@
+-- 内存压力指标：缓存、脏页和回写页（MB），/proc/vmstat 计数器的每秒速率，以及采集间隔内的 OOM kill 次数
+-- 在 0002_compact_storage.sql 之后执行一次；旧客户端不上报这些字段，写入为 0
+-- packed 模式的样本块会在下次写入时自动补齐新列，无需迁移
+
+ALTER TABLE status ADD COLUMN mem_buff_cache REAL;
+ALTER TABLE status ADD COLUMN mem_dirty REAL;
+ALTER TABLE status ADD COLUMN mem_writeback REAL;
+ALTER TABLE status ADD COLUMN pgmajfault_rate REAL;
+ALTER TABLE status ADD COLUMN pswpin_rate REAL;
+ALTER TABLE status ADD COLUMN pswpout_rate REAL;
+ALTER TABLE status ADD COLUMN pgscan_direct_rate REAL;
+ALTER TABLE status ADD COLUMN pgscan_kswapd_rate REAL;
+ALTER TABLE status ADD COLUMN pgsteal_direct_rate REAL;
+ALTER TABLE status ADD COLUMN pgsteal_kswapd_rate REAL;
+ALTER TABLE status ADD COLUMN oom_kill INTEGER;
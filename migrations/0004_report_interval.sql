@@ -0,0 +1,5 @@
+-- 客户端上报间隔（秒），失联告警按该间隔的倍数判断
+-- 在 0003_memory_pressure.sql 之后执行一次；旧客户端不上报该字段，写入为 0，此时使用观察到的间隔
+-- packed 模式的样本块会在下次写入时自动补齐新列，无需迁移
+
+ALTER TABLE status ADD COLUMN report_interval INTEGER;
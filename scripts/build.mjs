@@ -0,0 +1,117 @@
+// 构建脚本：把 index.html 及其依赖的脚本打包进 Worker，生成 dist/worker.js
+// 依赖的 CDN 脚本在构建时下载并缓存到 vendor/，运行时不再访问外部网络
+// 有脚本无法下载时构建失败；加 --allow-cdn 时保留 CDN 地址并继续构建
+// 用法：node scripts/build.mjs [--allow-cdn]
+import { createHash } from 'node:crypto';
+import { existsSync, mkdirSync, readFileSync, writeFileSync } from 'node:fs';
+import { basename, dirname, join } from 'node:path';
+import { fileURLToPath } from 'node:url';
+import { brotliCompressSync, constants, gzipSync } from 'node:zlib';
+
+const ROOT = join(dirname(fileURLToPath(import.meta.url)), '..');
+const VENDOR_DIR = join(ROOT, 'vendor');
+const DIST_DIR = join(ROOT, 'dist');
+const ASSETS_MARKER = 'const STATIC_ASSETS = {}; // 由 scripts/build.mjs 注入';
+const ALLOW_CDN = process.argv.includes('--allow-cdn');
+
+const contentHash = (data) => createHash('sha256').update(data).digest('hex').slice(0, 10);
+
+// 保守的压缩：去掉注释行、缩进和空行，不改动行内代码
+function minify(source) {
+    return source
+        .replace(/<!--[\s\S]*?-->/g, '')
+        .split('\n')
+        .map(line => line.trim())
+        .filter(line => line && !line.startsWith('//') && !/^\/\*.*\*\/$/.test(line))
+        .join('\n');
+}
+
+function compress(data) {
+    return {
+        br: brotliCompressSync(data, {
+            params: {
+                [constants.BROTLI_PARAM_QUALITY]: constants.BROTLI_MAX_QUALITY,
+                [constants.BROTLI_PARAM_SIZE_HINT]: data.length
+            }
+        }).toString('base64'),
+        gzip: gzipSync(data, { level: 9 }).toString('base64')
+    };
+}
+
+// 读取 vendor/ 中的缓存，没有时下载；下载失败时返回 null
+async function loadVendor(url) {
+    const { hostname, pathname } = new URL(url);
+    const name = (basename(pathname) || hostname).replace(/(\.js)?$/, '.js');
+    const file = join(VENDOR_DIR, `${hostname}${pathname}`.replace(/[^\w.-]+/g, '_'));
+    if (existsSync(file)) {
+        return { name, data: readFileSync(file) };
+    }
+    try {
+        const response = await fetch(url);
+        if (!response.ok) throw new Error(`HTTP ${response.status}`);
+        const data = Buffer.from(await response.arrayBuffer());
+        mkdirSync(VENDOR_DIR, { recursive: true });
+        writeFileSync(file, data);
+        return { name, data };
+    } catch (error) {
+        console.warn(`${ALLOW_CDN ? 'warning' : 'error'}: ${url} not bundled (${error.message})`);
+        return null;
+    }
+}
+
+async function build() {
+    const assets = {};
+    let html = readFileSync(join(ROOT, 'index.html'), 'utf8');
+
+    // 外部脚本改为带内容哈希的本地资源
+    const scripts = [...html.matchAll(/<script src="(https?:\/\/[^"]+)"><\/script>/g)];
+    const missing = [];
+    for (const [tag, url] of scripts) {
+        const vendor = await loadVendor(url);
+        if (!vendor) {
+            missing.push(url);
+            continue;
+        }
+        const path = `/assets/${vendor.name.replace(/\.js$/, '')}.${contentHash(vendor.data)}.js`;
+        assets[path] = {
+            type: 'application/javascript; charset=utf-8',
+            etag: `"${contentHash(vendor.data)}"`,
+            immutable: true,
+            ...compress(vendor.data)
+        };
+        html = html.replace(tag, `<script src="${path}"></script>`);
+    }
+    if (missing.length > 0) {
+        if (!ALLOW_CDN) {
+            throw new Error(`${missing.length} script(s) not bundled; put them in vendor/ or rerun with --allow-cdn to keep the CDN references`);
+        }
+        console.warn(`warning: keeping CDN references for ${missing.join(', ')}`);
+    }
+
+    const page = Buffer.from(minify(html));
+    assets['/'] = {
+        type: 'text/html; charset=utf-8',
+        etag: `"${contentHash(page)}"`,
+        immutable: false,
+        ...compress(page)
+    };
+
+    const worker = readFileSync(join(ROOT, 'worker.js'), 'utf8');
+    if (!worker.includes(ASSETS_MARKER)) {
+        throw new Error('STATIC_ASSETS marker not found in worker.js');
+    }
+    mkdirSync(DIST_DIR, { recursive: true });
+    writeFileSync(join(DIST_DIR, 'worker.js'),
+        worker.replace(ASSETS_MARKER, `const STATIC_ASSETS = ${JSON.stringify(assets, null, 4)};`));
+
+    for (const [path, asset] of Object.entries(assets)) {
+        const size = (encoded) => (Buffer.from(encoded, 'base64').length / 1024).toFixed(1);
+        console.log(`${path.padEnd(48)} br ${size(asset.br).padStart(7)} KiB  gzip ${size(asset.gzip).padStart(7)} KiB`);
+    }
+    console.log(`wrote ${join('dist', 'worker.js')}`);
+}
+
+build().catch(error => {
+    console.error(error);
+    process.exit(1);
+});
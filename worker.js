@@ -1,7 +1,19 @@
 // 常量定义
 const RATE_LIMIT = {
-    WINDOW_SIZE: 60, // 60秒窗口
-    MAX_REQUESTS: 100 // 每个窗口最大请求数
+    MAX_KEYS: 10000, // 每个限流器最多跟踪的键数量，超出时淘汰最久未访问的键
+    INGEST: {
+        WINDOW_SIZE: 60,   // 60秒窗口
+        MAX_REQUESTS: 20,  // agent 上报，按 machine_id 计数；未上报间隔的客户端使用此值
+        BURST_FACTOR: 2    // 上报了间隔的客户端，容量为窗口内正常上报次数的倍数
+    },
+    INGEST_IP: {
+        WINDOW_SIZE: 60,   // 60秒窗口
+        MAX_REQUESTS: 600  // agent 上报，按 IP 计数；machine_id 未经认证，先限制单个 IP 的总量，可用 INGEST_IP_LIMIT 覆盖
+    },
+    DASHBOARD: {
+        WINDOW_SIZE: 60,   // 60秒窗口
+        MAX_REQUESTS: 100  // 仪表盘接口，按 IP 计数
+    }
 };
 
 const ERROR_MESSAGES = {
@@ -17,6 +29,74 @@ const DATA_RETENTION = {
     MAX_RECORDS_PER_CLIENT: 10  // 每个客户端保留的最大记录数
 };
 
+// 存储模式：rows 每个样本一行；packed 每个客户端一行，最近的样本按列打包在 BLOB 中
+// 通过 Worker 变量 STORAGE_MODE 选择，默认 rows
+const STORAGE_MODES = {
+    ROWS: 'rows',
+    PACKED: 'packed'
+};
+
+// status 表的数值指标列及类型，real 列在 packed 模式下按两位小数存储
+// packed 模式按此顺序编码，新增列只能追加到末尾
+const METRIC_COLUMNS = {
+    insert_utc_ts: 'int',
+    uptime: 'int',
+    cpu_percent: 'real',
+    net_tx: 'int',
+    net_rx: 'int',
+    disks_total_kb: 'int',
+    disks_avail_kb: 'int',
+    cpu_num_cores: 'int',
+    mem_total: 'real',
+    mem_free: 'real',
+    mem_used: 'real',
+    swap_total: 'real',
+    swap_free: 'real',
+    process_count: 'int',
+    connection_count: 'int',
+    // 内存压力指标（migrations/0003_memory_pressure.sql）
+    mem_buff_cache: 'real',
+    mem_dirty: 'real',
+    mem_writeback: 'real',
+    pgmajfault_rate: 'real',
+    pswpin_rate: 'real',
+    pswpout_rate: 'real',
+    pgscan_direct_rate: 'real',
+    pgscan_kswapd_rate: 'real',
+    pgsteal_direct_rate: 'real',
+    pgsteal_kswapd_rate: 'real',
+    oom_kill: 'int',
+    // 客户端的上报间隔（秒）（migrations/0004_report_interval.sql）
+    report_interval: 'int'
+};
+
+// 慢变化的身份字段，存放在 client 表中，变化时 info_version 加一并记录到 client_info
+const IDENTITY_COLUMNS = ['name', 'system', 'location', 'ip_address', 'country_code'];
+
+// 告警配置
+const ALERT = {
+    // 默认规则，可通过 Worker 变量 ALERT_RULES 覆盖（每行一条，格式为 名称: 表达式）
+    DEFAULT_RULES: [
+        'cpu_high: cpu_percent > 90 for 5m',
+        'disk_low: disks_avail_kb / disks_total_kb < 0.05',
+        'offline: no_sample for 3x'
+    ].join('\n'),
+    // 失联超过触发阈值这么久（秒）的客户端视为已下线，新 isolate 首次看到时不再发出告警
+    STALE_MAX_AGE: 24 * 3600
+};
+
+// 打包后的静态资源（路径 -> 预压缩内容），未构建时为空，首页回退为从 GitHub 获取
+const STATIC_ASSETS = {}; // 由 scripts/build.mjs 注入
+
+// 静态资源缓存策略
+const ASSET_CACHE = {
+    IMMUTABLE: 'public, max-age=31536000, immutable', // 带内容哈希的资源
+    PAGE: 'public, max-age=300'                        // 首页，过期后通过 ETag 验证
+};
+
+// 解码后的静态资源，每个 isolate 首次访问时解码一次
+const decodedAssets = new Map();
+
 // 添加 GitHub index.html 链接常量
 const INDEX_HTML_URL = 'https://raw.githubusercontent.com/heyuecock/zsan/refs/heads/main/index.html';
 
@@ -26,6 +106,14 @@ let indexHtmlCache = {
     timestamp: 0
 };
 
+// 增量推送配置
+const STREAM = {
+    MAX_PATCHES: 1000,       // 变更缓冲区容量，游标落后更多时回退为全量快照
+    RESYNC_INTERVAL: 10,     // 从数据库对账的最小间隔（秒）
+    HEARTBEAT_INTERVAL: 10,  // SSE 心跳间隔（秒），同时触发对账
+    HUB_NAME: 'global'       // Durable Object 实例名称
+};
+
 // 添加国家代码映射
 const COUNTRY_CODE_MAP = {
     'hk': 'cn',  // 香港映射到中国
@@ -55,6 +143,11 @@ const utils = {
         };
     },
 
+    // 格式化 SSE 事件，id 为游标以便断线重连时通过 Last-Event-ID 续传
+    formatEvent: (message) => {
+        return `event: ${message.type}\nid: ${message.cursor}\ndata: ${JSON.stringify(message)}\n\n`;
+    },
+
     handleError: (error, status = 500) => {
         console.error('Error:', error);
         return new Response(
@@ -69,78 +162,924 @@ const utils = {
         );
     },
 
-    async cleanupOldData(env) {
-        try {
-            // 删除每个客户端超过10条的旧记录
-            await env.DB
+    // 处理单条状态记录，计算负载值并确保所有字段存在
+    processServer(server) {
+        const cpuPercent = parseFloat(server.cpu_percent) || 0;
+        const cpuCores = parseInt(server.cpu_num_cores) || 1;
+        
+        // 修改负载计算逻辑
+        // CPU 使用率转换为负载值的算法调整
+        // 负载值 = (CPU使用率 / 100) * CPU核心数
+        // 为了更真实的负载显示，我们调整计算方式
+        const baseLoad = (cpuPercent / 100);
+        const load_1min = Math.min(baseLoad * cpuCores, cpuCores * 4); // 限制最大值为核心数的4倍
+        const load_5min = Math.min(baseLoad * cpuCores * 0.9, cpuCores * 3); // 5分钟负载略低
+        const load_15min = Math.min(baseLoad * cpuCores * 0.8, cpuCores * 2); // 15分钟负载更低
+
+        const rawCountryCode = (server.country_code || 'xx').toLowerCase();
+        const mappedCountryCode = COUNTRY_CODE_MAP[rawCountryCode] || rawCountryCode;
+        
+        return {
+            ...server,
+            // 确保负载值至少为 0.01，避免显示 0
+            load_1min: Math.max(0.01, parseFloat(load_1min.toFixed(2))),
+            load_5min: Math.max(0.01, parseFloat(load_5min.toFixed(2))),
+            load_15min: Math.max(0.01, parseFloat(load_15min.toFixed(2))),
+            name: server.name || '未命名',
+            location: server.location || '未知',
+            system: server.system || 'Unknown',
+            uptime: parseInt(server.uptime) || 0,
+            net_tx: parseInt(server.net_tx) || 0,
+            net_rx: parseInt(server.net_rx) || 0,
+            disks_total_kb: parseInt(server.disks_total_kb) || 0,
+            disks_avail_kb: parseInt(server.disks_avail_kb) || 0,
+            cpu_num_cores: cpuCores,
+            mem_total: parseFloat(server.mem_total) || 0,
+            mem_free: parseFloat(server.mem_free) || 0,
+            mem_used: parseFloat(server.mem_used) || 0,
+            swap_total: parseFloat(server.swap_total) || 0,
+            swap_free: parseFloat(server.swap_free) || 0,
+            process_count: parseInt(server.process_count) || 0,
+            connection_count: parseInt(server.connection_count) || 0,
+            mem_buff_cache: parseFloat(server.mem_buff_cache) || 0,
+            mem_dirty: parseFloat(server.mem_dirty) || 0,
+            mem_writeback: parseFloat(server.mem_writeback) || 0,
+            pgmajfault_rate: parseFloat(server.pgmajfault_rate) || 0,
+            pswpin_rate: parseFloat(server.pswpin_rate) || 0,
+            pswpout_rate: parseFloat(server.pswpout_rate) || 0,
+            pgscan_direct_rate: parseFloat(server.pgscan_direct_rate) || 0,
+            pgscan_kswapd_rate: parseFloat(server.pgscan_kswapd_rate) || 0,
+            pgsteal_direct_rate: parseFloat(server.pgsteal_direct_rate) || 0,
+            pgsteal_kswapd_rate: parseFloat(server.pgsteal_kswapd_rate) || 0,
+            oom_kill: parseInt(server.oom_kill) || 0,
+            report_interval: parseInt(server.report_interval) || 0,
+            country_code: mappedCountryCode
+        };
+    },
+
+    // 从上报的表单中解析数值指标
+    parseSample(formData) {
+        const sample = {};
+        for (const [column, type] of Object.entries(METRIC_COLUMNS)) {
+            const value = formData.get(column);
+            sample[column] = (type === 'real' ? parseFloat(value) : parseInt(value)) || 0;
+        }
+        sample.insert_utc_ts = Math.floor(Date.now() / 1000);
+        return sample;
+    },
+
+    // 查询每个客户端的最新状态
+    async queryLatestStatus(env) {
+        const results = await storage.queryLatest(env);
+        return results.map(server => utils.processServer(server));
+    }
+};
+
+// packed 模式的样本块：每列先写首个值，再写相邻样本的差值，均为 zigzag 变长整数
+// 常量列每个样本只占 1 字节，计数器和时间戳只占差值的位数
+// 布局：[列数][样本数][第 1 列 × 样本数][第 2 列 × 样本数]...，旧块缺少的列读为 0
+export class PackedSamples {
+    constructor(capacity) {
+        this.capacity = capacity;
+        this.samples = [];
+    }
+
+    push(sample) {
+        this.samples.push(sample);
+        if (this.samples.length > this.capacity) {
+            this.samples.shift();
+        }
+    }
+
+    get count() {
+        return this.samples.length;
+    }
+
+    latest() {
+        return this.samples[this.samples.length - 1] || null;
+    }
+
+    static scale(type) {
+        return type === 'real' ? 100 : 1;
+    }
+
+    encode() {
+        const bytes = [];
+        const writeVarint = (value) => {
+            let zigzag = value >= 0 ? value * 2 : -value * 2 - 1;
+            while (zigzag >= 128) {
+                bytes.push(zigzag % 128 + 128);
+                zigzag = Math.floor(zigzag / 128);
+            }
+            bytes.push(zigzag);
+        };
+
+        const columns = Object.entries(METRIC_COLUMNS);
+        writeVarint(columns.length);
+        writeVarint(this.samples.length);
+        for (const [column, type] of columns) {
+            const scale = PackedSamples.scale(type);
+            let prev = 0;
+            for (const sample of this.samples) {
+                const value = Math.round((sample[column] || 0) * scale);
+                writeVarint(value - prev);
+                prev = value;
+            }
+        }
+        return new Uint8Array(bytes);
+    }
+
+    // D1 以数字数组返回 BLOB
+    static decode(data, capacity) {
+        const block = new PackedSamples(capacity);
+        if (!data) return block;
+
+        const bytes = data instanceof ArrayBuffer ? new Uint8Array(data) : data;
+        let offset = 0;
+        const readVarint = () => {
+            let zigzag = 0;
+            let multiplier = 1;
+            let byte;
+            do {
+                byte = bytes[offset++];
+                zigzag += (byte % 128) * multiplier;
+                multiplier *= 128;
+            } while (byte >= 128);
+            return zigzag % 2 === 0 ? zigzag / 2 : -(zigzag + 1) / 2;
+        };
+
+        const storedColumns = readVarint();
+        const count = readVarint();
+        const samples = Array.from({ length: count }, () => ({}));
+        Object.entries(METRIC_COLUMNS).forEach(([column, type], index) => {
+            const scale = PackedSamples.scale(type);
+            let value = 0;
+            for (const sample of samples) {
+                if (index < storedColumns) value += readVarint();
+                sample[column] = value / scale;
+            }
+        });
+        block.samples = samples.slice(-capacity);
+        return block;
+    }
+}
+
+// 存储层：身份字段只在变化时写入 client，指标按存储模式写入 status 或 status_packed
+const storage = {
+    mode(env) {
+        return env.STORAGE_MODE === STORAGE_MODES.PACKED ? STORAGE_MODES.PACKED : STORAGE_MODES.ROWS;
+    },
+
+    // 写入一个样本，返回客户端 ID
+    async saveStatus(env, machineId, identity, sample) {
+        const packed = storage.mode(env) === STORAGE_MODES.PACKED;
+        const { results } = await env.DB
+            .prepare(packed
+                ? `SELECT c.*, p.data FROM client c
+                   LEFT JOIN status_packed p ON p.client_id = c.id
+                   WHERE c.machine_id = ?`
+                : 'SELECT * FROM client WHERE machine_id = ?')
+            .bind(machineId)
+            .run();
+
+        const statements = [];
+        const identityValues = IDENTITY_COLUMNS.map(column => identity[column]);
+        const recordIdentity = (clientId, version) => env.DB
+            .prepare(`
+                INSERT INTO client_info (client_id, version, ${IDENTITY_COLUMNS.join(', ')}, valid_from_ts)
+                VALUES (?, ?, ${IDENTITY_COLUMNS.map(() => '?').join(', ')}, ?)
+            `)
+            .bind(clientId, version, ...identityValues, sample.insert_utc_ts);
+
+        let client = results && results[0];
+        if (!client) {
+            const { meta } = await env.DB
                 .prepare(`
-                    DELETE FROM status 
-                    WHERE id NOT IN (
-                        SELECT id
-                        FROM (
-                            SELECT id
-                            FROM status
-                            WHERE client_id = status.client_id
-                            ORDER BY insert_utc_ts DESC
-                            LIMIT ?
-                        )
-                    )
+                    INSERT INTO client (machine_id, ${IDENTITY_COLUMNS.join(', ')}, info_version)
+                    VALUES (?, ${IDENTITY_COLUMNS.map(() => '?').join(', ')}, 1)
                 `)
-                .bind(DATA_RETENTION.MAX_RECORDS_PER_CLIENT)
+                .bind(machineId, ...identityValues)
                 .run();
+            client = { id: meta.last_row_id, data: null };
+            statements.push(recordIdentity(client.id, 1));
+        } else if (IDENTITY_COLUMNS.some(column => client[column] !== identity[column])) {
+            const version = (client.info_version || 0) + 1;
+            statements.push(env.DB
+                .prepare(`
+                    UPDATE client SET ${IDENTITY_COLUMNS.map(column => `${column} = ?`).join(', ')}, info_version = ?
+                    WHERE id = ?
+                `)
+                .bind(...identityValues, version, client.id));
+            statements.push(recordIdentity(client.id, version));
+        }
+
+        const columns = Object.keys(METRIC_COLUMNS);
+        if (packed) {
+            const block = PackedSamples.decode(client.data, DATA_RETENTION.MAX_RECORDS_PER_CLIENT);
+            block.push(sample);
+            statements.push(env.DB
+                .prepare(`
+                    INSERT OR REPLACE INTO status_packed (client_id, sample_count, last_utc_ts, data)
+                    VALUES (?, ?, ?, ?)
+                `)
+                .bind(client.id, block.count, sample.insert_utc_ts, block.encode()));
+        } else {
+            statements.push(env.DB
+                .prepare(`
+                    INSERT INTO status (client_id, ${columns.join(', ')})
+                    VALUES (?, ${columns.map(() => '?').join(', ')})
+                `)
+                .bind(client.id, ...columns.map(column => sample[column])));
 
-            // 删除没有关联状态数据的客户端
-            await env.DB
+            // 只保留该客户端最新的记录，借助 (client_id, insert_utc_ts) 索引只扫描该客户端的数据
+            statements.push(env.DB
                 .prepare(`
-                    DELETE FROM client 
-                    WHERE id NOT IN (
-                        SELECT DISTINCT client_id 
-                        FROM status
+                    DELETE FROM status
+                    WHERE client_id = ? AND id NOT IN (
+                        SELECT id FROM status
+                        WHERE client_id = ?
+                        ORDER BY insert_utc_ts DESC
+                        LIMIT ?
                     )
                 `)
-                .run();
+                .bind(client.id, client.id, DATA_RETENTION.MAX_RECORDS_PER_CLIENT));
+        }
 
-            console.log(`Cleaned up old data, keeping ${DATA_RETENTION.MAX_RECORDS_PER_CLIENT} latest records per client`);
-        } catch (error) {
-            console.error('Error cleaning up old data:', error);
+        await env.DB.batch(statements);
+        return client.id;
+    },
+
+    // 查询每个客户端的最新一条原始记录
+    async queryLatest(env) {
+        const identity = IDENTITY_COLUMNS.map(column => `c.${column}`).join(', ');
+        if (storage.mode(env) === STORAGE_MODES.PACKED) {
+            const { results } = await env.DB
+                .prepare(`
+                    SELECT c.machine_id, ${identity}, p.client_id, p.data
+                    FROM status_packed p
+                    JOIN client c ON p.client_id = c.id
+                    ORDER BY p.last_utc_ts DESC
+                `)
+                .run();
+            return (results || []).map(({ data, ...row }) => ({
+                ...row,
+                ...PackedSamples.decode(data, DATA_RETENTION.MAX_RECORDS_PER_CLIENT).latest()
+            }));
         }
+
+        const { results } = await env.DB
+            .prepare(`
+                SELECT 
+                    c.machine_id,
+                    ${identity},
+                    s.*
+                FROM status s
+                JOIN client c ON s.client_id = c.id
+                WHERE s.id IN (
+                    SELECT MAX(id)
+                    FROM status
+                    GROUP BY client_id
+                )
+                ORDER BY s.insert_utc_ts DESC
+            `)
+            .run();
+        return results || [];
     }
 };
 
-// 速率限制中间件
-class RateLimiter {
-    constructor() {
-        this.requests = new Map();
+// 速率限制中间件：令牌桶，每个窗口补满 MAX_REQUESTS 个令牌，调用时可按键指定容量
+// 桶状态存放在定长数组中，槽位按最近访问顺序串成双向链表，更新和淘汰都是 O(1)
+export class RateLimiter {
+    constructor(limit, maxKeys = RATE_LIMIT.MAX_KEYS) {
+        this.capacity = limit.MAX_REQUESTS;
+        this.windowMs = limit.WINDOW_SIZE * 1000;
+        this.maxKeys = maxKeys;
+        this.slots = new Map();                   // key -> 槽位
+        this.keys = new Array(maxKeys);           // 槽位 -> key，淘汰时使用
+        this.tokens = new Float64Array(maxKeys);  // 剩余令牌数
+        this.updated = new Float64Array(maxKeys); // 上次更新时间（毫秒）
+        this.prev = new Int32Array(maxKeys);      // 链表：靠近最近访问端
+        this.next = new Int32Array(maxKeys);      // 链表：靠近最久未访问端
+        this.head = -1;                           // 最近访问的槽位
+        this.tail = -1;                           // 最久未访问的槽位
+    }
+
+    unlink(slot) {
+        const prev = this.prev[slot];
+        const next = this.next[slot];
+        if (prev >= 0) this.next[prev] = next; else this.head = next;
+        if (next >= 0) this.prev[next] = prev; else this.tail = prev;
     }
 
-    async checkLimit(request) {
-        const ip = request.headers.get('CF-Connecting-IP') || 'unknown';
-        const now = Date.now();
-        const windowStart = now - (RATE_LIMIT.WINDOW_SIZE * 1000);
+    pushFront(slot) {
+        this.prev[slot] = -1;
+        this.next[slot] = this.head;
+        if (this.head >= 0) this.prev[this.head] = slot; else this.tail = slot;
+        this.head = slot;
+    }
 
-        // 清理过期的请求记录
-        if (this.requests.has(ip)) {
-            this.requests.get(ip).timestamps = this.requests.get(ip).timestamps.filter(
-                time => time > windowStart
-            );
+    take(key, now = Date.now(), capacity = this.capacity) {
+        let slot = this.slots.get(key);
+        let tokens;
+        if (slot === undefined) {
+            if (this.slots.size < this.maxKeys) {
+                slot = this.slots.size;
+            } else {
+                // 淘汰最久未访问的键并复用其槽位
+                slot = this.tail;
+                this.unlink(slot);
+                this.slots.delete(this.keys[slot]);
+            }
+            this.slots.set(key, slot);
+            this.keys[slot] = key;
+            tokens = capacity;
+        } else {
+            this.unlink(slot);
+            tokens = Math.min(capacity,
+                this.tokens[slot] + (now - this.updated[slot]) * capacity / this.windowMs);
         }
+        this.pushFront(slot);
+        this.updated[slot] = now;
 
-        // 获取或初始化请求记录
-        const record = this.requests.get(ip) || { timestamps: [] };
-        
-        // 检查是否超过限制
-        if (record.timestamps.length >= RATE_LIMIT.MAX_REQUESTS) {
+        if (tokens < 1) {
+            this.tokens[slot] = tokens;
             return false;
         }
+        this.tokens[slot] = tokens - 1;
+        return true;
+    }
+
+    // 未指定键时按客户端 IP 计数
+    async checkLimit(request, key = null, capacity = this.capacity) {
+        return this.take(key || request.headers.get('CF-Connecting-IP') || 'unknown', Date.now(), capacity);
+    }
+}
+
+const rateLimits = {
+    // 单个 IP 的上报总量，NAT 后客户端较多时通过 INGEST_IP_LIMIT 调大
+    ingestIp(env) {
+        const limit = parseInt(env.INGEST_IP_LIMIT);
+        return limit > 0 ? limit : RATE_LIMIT.INGEST_IP.MAX_REQUESTS;
+    },
+
+    // 单个客户端的容量按其上报间隔计算，1 秒间隔的客户端也不会被限流
+    ingest(reportInterval) {
+        if (!(reportInterval > 0)) return RATE_LIMIT.INGEST.MAX_REQUESTS;
+        const perWindow = RATE_LIMIT.INGEST.WINDOW_SIZE / reportInterval;
+        return Math.max(RATE_LIMIT.INGEST.MAX_REQUESTS, Math.ceil(perWindow * RATE_LIMIT.INGEST.BURST_FACTOR));
+    }
+};
+
+const rateLimiters = {
+    ingest: new RateLimiter(RATE_LIMIT.INGEST),
+    ingestIp: new RateLimiter(RATE_LIMIT.INGEST_IP),
+    dashboard: new RateLimiter(RATE_LIMIT.DASHBOARD)
+};
+
+// 状态变更中心：保存每台服务器的最新状态，只向订阅者推送变化的服务器和字段
+class StatusHub {
+    constructor() {
+        this.epoch = crypto.randomUUID().slice(0, 8); // 区分不同实例的游标
+        this.seq = 0;
+        this.servers = new Map();   // machine_id -> 最新状态
+        this.patches = [];          // 按 seq 连续排列的变更记录
+        this.subscribers = new Set();
+        this.primed = false;
+        this.lastSync = 0;
+        this.syncing = null;
+    }
+
+    get cursor() {
+        return `${this.epoch}-${this.seq}`;
+    }
+
+    // 与数据库对账：首次调用时加载全量数据，之后按间隔补齐其他实例写入的变化
+    async sync(env) {
+        const now = Date.now() / 1000;
+        if (this.primed && now - this.lastSync < STREAM.RESYNC_INTERVAL) return;
+        if (!this.syncing) {
+            this.syncing = (async () => {
+                try {
+                    const servers = await utils.queryLatestStatus(env);
+                    const seen = new Set();
+                    for (const server of servers) {
+                        seen.add(server.machine_id);
+                        // 查询期间可能已经收到更新的样本，不用旧数据覆盖
+                        const current = this.servers.get(server.machine_id);
+                        if (current && current.insert_utc_ts > server.insert_utc_ts) continue;
+                        this.publish(server);
+                    }
+                    for (const machineId of this.servers.keys()) {
+                        if (!seen.has(machineId)) this.remove(machineId);
+                    }
+                    this.primed = true;
+                    this.lastSync = Date.now() / 1000;
+                } finally {
+                    this.syncing = null;
+                }
+            })();
+        }
+        await this.syncing;
+    }
 
-        // 记录新的请求
-        record.timestamps.push(now);
-        this.requests.set(ip, record);
+    // 合并一条最新状态，返回是否产生了变更
+    publish(server) {
+        const { id, ...next } = server;
+        const prev = this.servers.get(next.machine_id);
+        let fields = next;
+        if (prev) {
+            fields = {};
+            for (const key in next) {
+                if (prev[key] !== next[key]) fields[key] = next[key];
+            }
+            if (Object.keys(fields).length === 0) return false;
+        }
+        this.servers.set(next.machine_id, next);
+        this.record({ machine_id: next.machine_id, fields });
         return true;
     }
+
+    remove(machineId) {
+        if (!this.servers.delete(machineId)) return;
+        this.record({ machine_id: machineId, removed: true });
+    }
+
+    record(patch) {
+        this.seq++;
+        this.patches.push({ seq: this.seq, ...patch });
+        if (this.patches.length > STREAM.MAX_PATCHES) {
+            this.patches.shift();
+        }
+        if (this.primed && this.subscribers.size > 0) {
+            this.broadcast({ type: 'patch', cursor: this.cursor, patches: [patch] });
+        }
+    }
+
+    // 返回游标之后的合并变更；游标无效或已过期时返回全量快照
+    changesSince(cursor) {
+        const [epoch, seqText] = String(cursor || '').split('-');
+        const seq = parseInt(seqText);
+        const first = this.patches.length > 0 ? this.patches[0].seq : this.seq + 1;
+        if (epoch !== this.epoch || !(seq >= first - 1 && seq <= this.seq)) {
+            return {
+                type: 'snapshot',
+                cursor: this.cursor,
+                servers: Array.from(this.servers.values())
+            };
+        }
+
+        // 同一台服务器的多次变更合并为一条
+        const merged = new Map();
+        for (let i = seq + 1 - first; i < this.patches.length; i++) {
+            const { machine_id, fields, removed } = this.patches[i];
+            const entry = merged.get(machine_id);
+            if (removed) {
+                merged.set(machine_id, { machine_id, removed: true });
+            } else if (entry && !entry.removed) {
+                Object.assign(entry.fields, fields);
+            } else {
+                merged.set(machine_id, { machine_id, fields: { ...fields } });
+            }
+        }
+        return { type: 'patch', cursor: this.cursor, patches: Array.from(merged.values()) };
+    }
+
+    broadcast(message) {
+        const chunk = utils.formatEvent(message);
+        for (const send of this.subscribers) {
+            send(chunk);
+        }
+    }
+
+    // 建立 SSE 连接：先补发游标之后的变更，再持续推送新的变更
+    async openStream(request, env) {
+        await this.sync(env);
+
+        const url = new URL(request.url);
+        const cursor = url.searchParams.get('cursor') || request.headers.get('Last-Event-ID');
+        const { readable, writable } = new TransformStream();
+        const writer = writable.getWriter();
+        const encoder = new TextEncoder();
+
+        let heartbeat = null;
+        const send = (chunk) => {
+            writer.write(encoder.encode(chunk)).catch(() => close());
+        };
+        const close = () => {
+            if (!this.subscribers.delete(send)) return;
+            clearInterval(heartbeat);
+            writer.close().catch(() => {});
+        };
+
+        send(utils.formatEvent(this.changesSince(cursor)));
+        this.subscribers.add(send);
+        heartbeat = setInterval(() => {
+            send(': ping\n\n');
+            this.sync(env).catch(error => console.error('Error syncing status hub:', error));
+        }, STREAM.HEARTBEAT_INTERVAL * 1000);
+        request.signal?.addEventListener('abort', close);
+
+        return new Response(readable, {
+            headers: {
+                'Content-Type': 'text/event-stream',
+                'Access-Control-Allow-Origin': '*',
+                'Cache-Control': 'no-cache'
+            }
+        });
+    }
+
+    async handleChanges(request, env) {
+        await this.sync(env);
+        const cursor = new URL(request.url).searchParams.get('cursor');
+        return new Response(
+            JSON.stringify(utils.formatResponse(true, this.changesSince(cursor))),
+            {
+                headers: {
+                    'Content-Type': 'application/json',
+                    'Access-Control-Allow-Origin': '*',
+                    'Cache-Control': 'no-cache'
+                }
+            }
+        );
+    }
+}
+
+// 未绑定 Durable Object 时，每个 isolate 使用本地变更中心
+const statusHub = new StatusHub();
+
+// 获取变更中心：绑定 STATUS_HUB 时转发到全局唯一的 Durable Object
+function getHubStub(env) {
+    if (!env.STATUS_HUB) return null;
+    return env.STATUS_HUB.get(env.STATUS_HUB.idFromName(STREAM.HUB_NAME));
+}
+
+// 告警规则编译：把规则文本编译成闭包，每个 isolate 只编译一次
+// 阈值规则：<表达式> <比较符> <阈值> [for <时长>]，表达式支持指标列、数字、+ - * / 和括号，时长单位 s/m/h
+// 失联规则：no_sample for <倍数>x，超过上报间隔的若干倍没有收到样本时触发
+const alertRules = {
+    cache: { source: null, rules: [] },
+
+    compile(source) {
+        if (alertRules.cache.source === source) return alertRules.cache.rules;
+        const rules = [];
+        for (const line of source.split(/[\n;]/)) {
+            const text = line.trim();
+            if (!text) continue;
+            const colon = text.indexOf(':');
+            const name = colon > 0 ? text.slice(0, colon).trim() : text;
+            const expr = colon > 0 ? text.slice(colon + 1).trim() : text;
+            try {
+                rules.push({ name, expr, ...alertRules.parse(expr) });
+            } catch (error) {
+                console.error(`Invalid alert rule "${text}":`, error.message);
+            }
+        }
+        alertRules.cache = { source, rules };
+        return rules;
+    },
+
+    parse(expr) {
+        const tokens = expr.match(/\d+(?:\.\d+)?[smhx]?|[a-z_][a-z0-9_]*|>=|<=|==|!=|[-+*\/()<>]|\S/gi);
+        let pos = 0;
+        const peek = () => tokens[pos];
+        const next = () => tokens[pos++];
+        const expect = (token) => {
+            if (next() !== token) throw new Error(`expected "${token}"`);
+        };
+
+        const staleMatch = expr.match(/^no_sample\s+for\s+(\d+(?:\.\d+)?)x$/i);
+        if (staleMatch) {
+            return { type: 'stale', factor: parseFloat(staleMatch[1]) };
+        }
+
+        const factor = () => {
+            const token = next();
+            if (token === '(') {
+                const inner = sum();
+                expect(')');
+                return inner;
+            }
+            if (token === '-') {
+                const operand = factor();
+                return sample => -operand(sample);
+            }
+            if (/^\d+(\.\d+)?$/.test(token)) {
+                const value = parseFloat(token);
+                return () => value;
+            }
+            if (Object.hasOwn(METRIC_COLUMNS, token)) {
+                return sample => sample[token];
+            }
+            throw new Error(`unknown metric "${token}"`);
+        };
+        const binary = (operand, operators) => () => {
+            let left = operand();
+            while (Object.hasOwn(operators, peek())) {
+                const apply = operators[next()];
+                const lhs = left;
+                const rhs = operand();
+                left = sample => apply(lhs(sample), rhs(sample));
+            }
+            return left;
+        };
+        const product = binary(factor, { '*': (a, b) => a * b, '/': (a, b) => a / b });
+        const sum = binary(product, { '+': (a, b) => a + b, '-': (a, b) => a - b });
+
+        const comparators = {
+            '>': (a, b) => a > b, '>=': (a, b) => a >= b,
+            '<': (a, b) => a < b, '<=': (a, b) => a <= b,
+            '==': (a, b) => a === b, '!=': (a, b) => a !== b
+        };
+        const value = sum();
+        const op = next();
+        if (!Object.hasOwn(comparators, op)) throw new Error('expected comparison');
+        const compare = comparators[op];
+        const threshold = sum();
+
+        let duration = 0;
+        if (peek() === 'for') {
+            next();
+            const match = (next() || '').match(/^(\d+(?:\.\d+)?)([smh])$/);
+            if (!match) throw new Error('expected duration such as 30s, 5m or 1h');
+            duration = parseFloat(match[1]) * { s: 1, m: 60, h: 3600 }[match[2]];
+        }
+        if (pos < tokens.length) throw new Error(`unexpected "${peek()}"`);
+
+        return {
+            type: 'threshold',
+            duration,
+            value,
+            test: sample => compare(value(sample), threshold(sample))
+        };
+    }
+};
+
+// 告警引擎：每个客户端只保存最近上报时间、上报间隔估计和每条规则的状态，
+// 每个样本的计算量为 O(规则数)，不查询历史数据
+class AlertEngine {
+    constructor() {
+        this.clients = new Map(); // machine_id -> { name, lastSeen, interval, reported, rules: [{ since, firing }] }
+    }
+
+    clientState(machineId, rules) {
+        let state = this.clients.get(machineId);
+        if (!state || state.rules.length !== rules.length) {
+            state = {
+                name: machineId,
+                lastSeen: 0,
+                interval: 0,
+                reported: 0, // 客户端上报的间隔，旧客户端为 0
+                rules: rules.map(() => ({ since: null, firing: false }))
+            };
+            this.clients.set(machineId, state);
+        }
+        return state;
+    }
+
+    event(rule, server, state, firing, ts, value = null) {
+        return {
+            rule: rule.name,
+            expr: rule.expr,
+            state: firing ? 'firing' : 'resolved',
+            machine_id: server.machine_id,
+            name: state.name,
+            value,
+            ts
+        };
+    }
+
+    // 处理一个新样本，返回状态发生变化的告警
+    observe(server, rules) {
+        if (rules.length === 0) return [];
+        const state = this.clientState(server.machine_id, rules);
+        const ts = server.insert_utc_ts;
+        const gap = ts - state.lastSeen;
+        if (state.lastSeen > 0 && gap > 0) {
+            // 指数加权平均，偶尔的重试或延迟不会大幅改变估计值
+            state.interval = state.interval > 0 ? state.interval * 0.8 + gap * 0.2 : gap;
+        }
+        state.lastSeen = Math.max(state.lastSeen, ts);
+        state.name = server.name || state.name;
+        if (server.report_interval > 0) state.reported = server.report_interval;
+
+        const events = [];
+        rules.forEach((rule, i) => {
+            const ruleState = state.rules[i];
+            if (rule.type === 'stale') {
+                if (ruleState.firing) {
+                    ruleState.firing = false;
+                    events.push(this.event(rule, server, state, false, ts));
+                }
+                return;
+            }
+
+            if (rule.test(server)) {
+                if (ruleState.since === null) ruleState.since = ts;
+                if (!ruleState.firing && ts - ruleState.since >= rule.duration) {
+                    ruleState.firing = true;
+                    events.push(this.event(rule, server, state, true, ts, rule.value(server)));
+                }
+            } else {
+                ruleState.since = null;
+                if (ruleState.firing) {
+                    ruleState.firing = false;
+                    events.push(this.event(rule, server, state, false, ts, rule.value(server)));
+                }
+            }
+        });
+        return events;
+    }
+
+    // 定时检查失联：先用数据库中的最新上报时间补齐其他 isolate 收到的样本
+    async sweep(env, rules, now = Math.floor(Date.now() / 1000)) {
+        const staleRules = rules.map((rule, i) => [rule, i]).filter(([rule]) => rule.type === 'stale');
+        if (staleRules.length === 0) return [];
+
+        for (const server of await utils.queryLatestStatus(env)) {
+            const state = this.clientState(server.machine_id, rules);
+            state.lastSeen = Math.max(state.lastSeen, server.insert_utc_ts);
+            state.name = server.name || state.name;
+            if (server.report_interval > 0) state.reported = server.report_interval;
+        }
+
+        const events = [];
+        for (const [machineId, state] of this.clients) {
+            // 不猜测间隔：客户端未上报间隔、也未观察到两次上报时不判断失联
+            const interval = state.reported || state.interval;
+            if (!interval) continue;
+            const silence = now - state.lastSeen;
+            for (const [rule, i] of staleRules) {
+                const ruleState = state.rules[i];
+                const threshold = interval * rule.factor;
+                const stale = silence > threshold;
+                if (stale && !ruleState.firing && silence > threshold + ALERT.STALE_MAX_AGE) {
+                    // 早已失联的客户端在之前的 isolate 中已经告警过，只记录状态，恢复时仍发出恢复事件
+                    ruleState.firing = true;
+                    continue;
+                }
+                if (stale !== ruleState.firing) {
+                    // 恢复也在这里判断：收到样本的可能是另一个 isolate，本 isolate 只能从数据库得知
+                    ruleState.firing = stale;
+                    events.push(this.event(rule, { machine_id: machineId }, state, stale, now, silence));
+                }
+            }
+        }
+        return events;
+    }
+}
+
+// 告警通知渠道：配置 ALERT_WEBHOOK_URL 时以 JSON POST 到该地址，否则写入日志
+const alertSinks = {
+    webhook: (env) => async (events) => {
+        const response = await fetch(env.ALERT_WEBHOOK_URL, {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify({ alerts: events })
+        });
+        if (!response.ok) {
+            throw new Error(`Alert webhook failed: ${response.status}`);
+        }
+    },
+
+    console: () => async (events) => {
+        for (const event of events) {
+            console.log('Alert:', JSON.stringify(event));
+        }
+    }
+};
+
+// 未绑定 Durable Object 时，每个 isolate 使用本地告警引擎
+const alertEngine = new AlertEngine();
+
+const alerts = {
+    rules(env) {
+        return alertRules.compile(env.ALERT_RULES ?? ALERT.DEFAULT_RULES);
+    },
+
+    // 发送告警；有 ctx 时在响应返回后发送，不阻塞上报
+    async deliver(env, events, ctx) {
+        if (events.length === 0) return;
+        const sink = env.ALERT_WEBHOOK_URL ? alertSinks.webhook(env) : alertSinks.console(env);
+        const pending = sink(events).catch(error => console.error('Error delivering alerts:', error));
+        if (ctx?.waitUntil) {
+            ctx.waitUntil(pending);
+        } else {
+            await pending;
+        }
+    }
+};
+
+// 写入新状态后通知变更中心并评估告警
+async function publishStatus(env, server, ctx) {
+    const stub = getHubStub(env);
+    if (stub) {
+        // 样本已写入数据库，通知 Durable Object 不阻塞上报响应
+        const pending = stub.fetch('https://status-hub/publish', {
+            method: 'POST',
+            body: JSON.stringify(server)
+        }).catch(error => console.error('Error publishing to status hub:', error));
+        if (ctx?.waitUntil) {
+            ctx.waitUntil(pending);
+        } else {
+            await pending;
+        }
+        return;
+    }
+    if (statusHub.primed) {
+        // 本地中心尚未加载时跳过，首次订阅会从数据库加载全量数据
+        statusHub.publish(server);
+    }
+    await alerts.deliver(env, alertEngine.observe(server, alerts.rules(env)), ctx);
 }
 
-const rateLimiter = new RateLimiter();
+// 定时任务：检查失联的服务器
+async function sweepAlerts(env) {
+    const stub = getHubStub(env);
+    if (stub) {
+        await stub.fetch('https://status-hub/sweep', { method: 'POST' });
+        return;
+    }
+    const events = await alertEngine.sweep(env, alerts.rules(env));
+    await alerts.deliver(env, events);
+}
+
+// Durable Object：跨 isolate 共享的变更中心和告警引擎
+export class StatusHubObject {
+    constructor(state, env) {
+        this.state = state;
+        this.env = env;
+        this.hub = new StatusHub();
+        this.alerts = new AlertEngine();
+    }
+
+    async fetch(request) {
+        const url = new URL(request.url);
+        if (request.method === 'POST' && url.pathname === '/publish') {
+            const server = await request.json();
+            // 对账查询全部客户端，放在后台执行，单次上报的耗时不随服务器数量增长
+            this.state.waitUntil(this.hub.sync(this.env)
+                .catch(error => console.error('Error syncing status hub:', error)));
+            if (this.hub.primed) {
+                // 尚未加载时跳过，加载完成后数据库中已包含这条样本
+                this.hub.publish(server);
+            }
+            // 在响应返回后发送，Webhook 的延迟和失败不影响上报
+            await alerts.deliver(this.env, this.alerts.observe(server, alerts.rules(this.env)), this.state);
+            return new Response(null, { status: 204 });
+        }
+        if (request.method === 'POST' && url.pathname === '/sweep') {
+            await alerts.deliver(this.env, await this.alerts.sweep(this.env, alerts.rules(this.env)));
+            return new Response(null, { status: 204 });
+        }
+        if (url.pathname === '/status/stream') {
+            return this.hub.openStream(request, this.env);
+        }
+        return this.hub.handleChanges(request, this.env);
+    }
+}
+
+// 按 Accept-Encoding 返回预压缩的静态资源
+function serveStaticAsset(request, path) {
+    const asset = STATIC_ASSETS[path];
+    const headers = {
+        'Content-Type': asset.type,
+        'Access-Control-Allow-Origin': '*',
+        'Cache-Control': asset.immutable ? ASSET_CACHE.IMMUTABLE : ASSET_CACHE.PAGE,
+        'ETag': asset.etag,
+        'Vary': 'Accept-Encoding'
+    };
+
+    // If-None-Match 可能包含多个 ETag，中间代理也常把 ETag 改为弱校验（W/"..."），按弱比较处理
+    const ifNoneMatch = request.headers.get('If-None-Match');
+    if (ifNoneMatch && ifNoneMatch.split(',').some(tag => {
+        tag = tag.trim();
+        return tag === '*' || tag.replace(/^W\//, '') === asset.etag;
+    })) {
+        return new Response(null, { status: 304, headers });
+    }
+
+    let decoded = decodedAssets.get(path);
+    if (!decoded) {
+        const decode = (base64) => Uint8Array.from(atob(base64), c => c.charCodeAt(0));
+        decoded = { br: decode(asset.br), gzip: decode(asset.gzip) };
+        decodedAssets.set(path, decoded);
+    }
+
+    const acceptEncoding = request.headers.get('Accept-Encoding') || '';
+    const encoding = /\bbr\b/.test(acceptEncoding) ? 'br'
+        : /\bgzip\b/.test(acceptEncoding) ? 'gzip' : null;
+    if (!encoding) {
+        // 极少数不支持压缩的客户端，现场解压 gzip 版本
+        const body = new Response(decoded.gzip).body.pipeThrough(new DecompressionStream('gzip'));
+        return new Response(body, { headers });
+    }
+
+    // encodeBody: 'manual' 让运行时直接发送已压缩的内容
+    return new Response(decoded[encoding], {
+        encodeBody: 'manual',
+        headers: { ...headers, 'Content-Encoding': encoding }
+    });
+}
 
 // 修改 getLocationInfo 函数
 async function getLocationInfo(request) {
@@ -172,7 +1111,7 @@ async function getLocationInfo(request) {
 
 // 路由处理函数
 const routeHandlers = {
-    async handlePostStatus(request, env) {
+    async handlePostStatus(request, env, ctx) {
         try {
             // 检查 env.DB 是否存在
             if (!env.DB) {
@@ -180,8 +1119,8 @@ const routeHandlers = {
                 return utils.handleError(new Error('数据库未配置'), 500);
             }
 
-            // 速率限制检查
-            if (!await rateLimiter.checkLimit(request)) {
+            // 速率限制检查：先按 IP 限制总量，轮换 machine_id 不能绕过限制或挤掉其他客户端的计数
+            if (!await rateLimiters.ingestIp.checkLimit(request, null, rateLimits.ingestIp(env))) {
                 return utils.handleError(new Error(ERROR_MESSAGES.RATE_LIMIT), 429);
             }
 
@@ -194,10 +1133,12 @@ const routeHandlers = {
 
             // 清理和验证数据
             const machineId = utils.sanitizeString(formData.get('machine_id'));
-            const name = utils.sanitizeString(formData.get('name')) || '未命名';
-            const system = utils.sanitizeString(formData.get('system')) || '';
-            const location = utils.sanitizeString(formData.get('location')) || '未知';
-            const ipAddress = formData.get('ip_address');
+
+            // 再按 machine_id 计数，同一出口 IP 后的多台服务器互不影响
+            const reportInterval = parseInt(formData.get('report_interval'));
+            if (!await rateLimiters.ingest.checkLimit(request, `machine:${machineId}`, rateLimits.ingest(reportInterval))) {
+                return utils.handleError(new Error(ERROR_MESSAGES.RATE_LIMIT), 429);
+            }
 
             // 获取地理位置信息
             const locationInfo = await getLocationInfo(request);
@@ -206,71 +1147,31 @@ const routeHandlers = {
             console.log('Location info:', locationInfo);
             console.log('Inserting status with country_code:', locationInfo?.country_code);
 
-            // 数据库操作
-            let clientId;
-            let { results } = await env.DB
-                .prepare('SELECT id FROM client WHERE machine_id = ?')
-                .bind(machineId)
-                .run();
-
-            if (results && results[0]) {
-                clientId = results[0].id;
-                await env.DB
-                    .prepare('UPDATE client SET name = ? WHERE id = ?')
-                    .bind(name, clientId)
-                    .run();
-            } else {
-                const { meta } = await env.DB
-                    .prepare('INSERT INTO client (machine_id, name) VALUES (?, ?)')
-                    .bind(machineId, name)
-                    .run();
-                clientId = meta.last_row_id;
-            }
+            const identity = {
+                name: utils.sanitizeString(formData.get('name')) || '未命名',
+                system: utils.sanitizeString(formData.get('system')) || '',
+                location: utils.sanitizeString(formData.get('location')) || '未知',
+                ip_address: utils.sanitizeString(formData.get('ip_address')),
+                country_code: locationInfo?.country_code || 'xx'
+            };
+            const sample = utils.parseSample(formData);
 
-            // 插入状态数据
-            await env.DB
-                .prepare(`
-                    INSERT INTO status (
-                        client_id, name, system, location, insert_utc_ts,
-                        uptime, cpu_percent, net_tx, net_rx, disks_total_kb,
-                        disks_avail_kb, cpu_num_cores, mem_total, mem_free,
-                        mem_used, swap_total, swap_free, process_count,
-                        connection_count, ip_address, country_code
-                    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-                `)
-                .bind(
-                    clientId,
-                    name,
-                    system,
-                    location,
-                    Math.floor(Date.now() / 1000),
-                    parseInt(formData.get('uptime')) || 0,
-                    parseFloat(formData.get('cpu_percent')) || 0,
-                    parseInt(formData.get('net_tx')) || 0,
-                    parseInt(formData.get('net_rx')) || 0,
-                    parseInt(formData.get('disks_total_kb')) || 0,
-                    parseInt(formData.get('disks_avail_kb')) || 0,
-                    parseInt(formData.get('cpu_num_cores')) || 0,
-                    parseFloat(formData.get('mem_total')) || 0,
-                    parseFloat(formData.get('mem_free')) || 0,
-                    parseFloat(formData.get('mem_used')) || 0,
-                    parseFloat(formData.get('swap_total')) || 0,
-                    parseFloat(formData.get('swap_free')) || 0,
-                    parseInt(formData.get('process_count')) || 0,
-                    parseInt(formData.get('connection_count')) || 0,
-                    ipAddress,
-                    locationInfo?.country_code || 'xx'
-                )
-                .run();
+            // 数据库操作
+            const clientId = await storage.saveStatus(env, machineId, identity, sample);
 
-            // 每次插入数据后都执行清理
-            await utils.cleanupOldData(env);
+            // 推送变更给仪表盘订阅者
+            await publishStatus(env, utils.processServer({
+                machine_id: machineId,
+                client_id: clientId,
+                ...identity,
+                ...sample
+            }), ctx);
 
             return new Response(
                 JSON.stringify(utils.formatResponse(true, {
                     client_id: clientId,
-                    name: name,
-                    location: location
+                    name: identity.name,
+                    location: identity.location
                 })),
                 {
                     headers: {
@@ -292,71 +1193,11 @@ const routeHandlers = {
                 return utils.handleError(new Error('数据库未配置'), 500);
             }
 
-            if (!await rateLimiter.checkLimit(request)) {
+            if (!await rateLimiters.dashboard.checkLimit(request)) {
                 return utils.handleError(new Error(ERROR_MESSAGES.RATE_LIMIT), 429);
             }
 
-            const { results } = await env.DB
-                .prepare(`
-                    SELECT 
-                        c.machine_id,
-                        s.*
-                    FROM status s
-                    JOIN client c ON s.client_id = c.id
-                    WHERE s.id IN (
-                        SELECT MAX(id)
-                        FROM status
-                        GROUP BY client_id
-                    )
-                    ORDER BY s.insert_utc_ts DESC
-                `)
-                .run();
-
-            // 在 handleGetLatestStatus 中添加日志
-            console.log('Retrieved results:', results);
-
-            // 处理结果，计算负载值并确保所有字段存在
-            const processedResults = (results || []).map(server => {
-                const cpuPercent = parseFloat(server.cpu_percent) || 0;
-                const cpuCores = parseInt(server.cpu_num_cores) || 1;
-                
-                // 修改负载计算逻辑
-                // CPU 使用率转换为负载值的算法调整
-                // 负载值 = (CPU使用率 / 100) * CPU核心数
-                // 为了更真实的负载显示，我们调整计算方式
-                const baseLoad = (cpuPercent / 100);
-                const load_1min = Math.min(baseLoad * cpuCores, cpuCores * 4); // 限制最大值为核心数的4倍
-                const load_5min = Math.min(baseLoad * cpuCores * 0.9, cpuCores * 3); // 5分钟负载略低
-                const load_15min = Math.min(baseLoad * cpuCores * 0.8, cpuCores * 2); // 15分钟负载更低
-
-                const rawCountryCode = (server.country_code || 'xx').toLowerCase();
-                const mappedCountryCode = COUNTRY_CODE_MAP[rawCountryCode] || rawCountryCode;
-                
-                return {
-                    ...server,
-                    // 确保负载值至少为 0.01，避免显示 0
-                    load_1min: Math.max(0.01, parseFloat(load_1min.toFixed(2))),
-                    load_5min: Math.max(0.01, parseFloat(load_5min.toFixed(2))),
-                    load_15min: Math.max(0.01, parseFloat(load_15min.toFixed(2))),
-                    name: server.name || '未命名',
-                    location: server.location || '未知',
-                    system: server.system || 'Unknown',
-                    uptime: parseInt(server.uptime) || 0,
-                    net_tx: parseInt(server.net_tx) || 0,
-                    net_rx: parseInt(server.net_rx) || 0,
-                    disks_total_kb: parseInt(server.disks_total_kb) || 0,
-                    disks_avail_kb: parseInt(server.disks_avail_kb) || 0,
-                    cpu_num_cores: cpuCores,
-                    mem_total: parseFloat(server.mem_total) || 0,
-                    mem_free: parseFloat(server.mem_free) || 0,
-                    mem_used: parseFloat(server.mem_used) || 0,
-                    swap_total: parseFloat(server.swap_total) || 0,
-                    swap_free: parseFloat(server.swap_free) || 0,
-                    process_count: parseInt(server.process_count) || 0,
-                    connection_count: parseInt(server.connection_count) || 0,
-                    country_code: mappedCountryCode
-                };
-            });
+            const processedResults = await utils.queryLatestStatus(env);
 
             return new Response(
                 JSON.stringify(utils.formatResponse(true, processedResults)),
@@ -374,7 +1215,55 @@ const routeHandlers = {
         }
     },
 
+    async handleGetStatusStream(request, env) {
+        try {
+            if (!env.DB) {
+                console.error('Database binding not found');
+                return utils.handleError(new Error('数据库未配置'), 500);
+            }
+
+            if (!await rateLimiters.dashboard.checkLimit(request)) {
+                return utils.handleError(new Error(ERROR_MESSAGES.RATE_LIMIT), 429);
+            }
+
+            const stub = getHubStub(env);
+            if (stub) {
+                return await stub.fetch(request);
+            }
+            return await statusHub.openStream(request, env);
+        } catch (error) {
+            console.error('Error in handleGetStatusStream:', error);
+            return utils.handleError(error);
+        }
+    },
+
+    async handleGetStatusChanges(request, env) {
+        try {
+            if (!env.DB) {
+                console.error('Database binding not found');
+                return utils.handleError(new Error('数据库未配置'), 500);
+            }
+
+            if (!await rateLimiters.dashboard.checkLimit(request)) {
+                return utils.handleError(new Error(ERROR_MESSAGES.RATE_LIMIT), 429);
+            }
+
+            const stub = getHubStub(env);
+            if (stub) {
+                return await stub.fetch(request);
+            }
+            return await statusHub.handleChanges(request, env);
+        } catch (error) {
+            console.error('Error in handleGetStatusChanges:', error);
+            return utils.handleError(error);
+        }
+    },
+
     async handleGetIndex(request, env) {
+        if (STATIC_ASSETS['/']) {
+            return serveStaticAsset(request, '/');
+        }
+
         try {
             const CACHE_TTL = 3600; // 缓存1小时
             const now = Date.now() / 1000;
@@ -435,6 +1324,14 @@ const routeHandlers = {
         }
     },
 
+    async handleGetAsset(request) {
+        const path = new URL(request.url).pathname;
+        if (!STATIC_ASSETS[path]) {
+            return utils.handleError(new Error(ERROR_MESSAGES.NOT_FOUND), 404);
+        }
+        return serveStaticAsset(request, path);
+    },
+
     async handleGetStatus(request) {
         return new Response('zsan', {  // 修改返回值为 'zsan'
             headers: { 
@@ -458,7 +1355,7 @@ const routeHandlers = {
 
 // 主导出
 export default {
-    async fetch(request, env) {
+    async fetch(request, env, ctx) {
         try {
             // 添加调试日志
             console.log('Request URL:', request.url);
@@ -478,6 +1375,8 @@ export default {
             const routes = {
                 'POST /status': routeHandlers.handlePostStatus,
                 'GET /status/latest': routeHandlers.handleGetLatestStatus,
+                'GET /status/stream': routeHandlers.handleGetStatusStream,
+                'GET /status/changes': routeHandlers.handleGetStatusChanges,
                 'GET /': routeHandlers.handleGetIndex,
                 'GET /status': routeHandlers.handleGetStatus,
             };
@@ -487,7 +1386,12 @@ export default {
             const handler = routes[routeKey];
 
             if (handler) {
-                return await handler(request, env);
+                return await handler(request, env, ctx);
+            }
+
+            // 带内容哈希的静态资源
+            if (method === 'GET' && path.startsWith('/assets/')) {
+                return await routeHandlers.handleGetAsset(request, env);
             }
 
             console.error('Route not found:', routeKey);
@@ -496,6 +1400,10 @@ export default {
             console.error('Error in fetch:', error);
             return utils.handleError(error);
         }
-    }
-};
+    },
 
+    // Cron 触发器：检查失联告警
+    async scheduled(event, env, ctx) {
+        ctx.waitUntil(sweepAlerts(env).catch(error => console.error('Error in scheduled:', error)));
+    }
+};
\ No newline at end of file
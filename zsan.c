@@ -15,6 +15,16 @@
 #include <errno.h>
 #include <ifaddrs.h>
 #include <arpa/inet.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#define CONFIG_FILE "/root/.kunlun/config"
+#define PROC_PATH_MAX 320
+#define STATE_DIR "/var/lib/zsan"
+#define STATE_MACHINE_ID_FILE STATE_DIR "/machine-id"  // 系统没有 machine-id 时持久化生成的 ID
 
 // 添加函数声明
 void log_message(const char *level, const char *format, ...);
@@ -38,21 +48,51 @@ typedef struct {
     double swap_free;              // 交换分区可用
     int process_count;             // 进程数
     int connection_count;          // 连接数
+    double mem_buff_cache;         // 缓存和缓冲区内存
+    double mem_dirty;              // 脏页
+    double mem_writeback;          // 正在回写的页
+    double pgmajfault_rate;        // 每秒主缺页次数
+    double pswpin_rate;            // 每秒换入页数
+    double pswpout_rate;           // 每秒换出页数
+    double pgscan_direct_rate;     // 每秒直接回收扫描页数
+    double pgscan_kswapd_rate;     // 每秒 kswapd 扫描页数
+    double pgsteal_direct_rate;    // 每秒直接回收页数
+    double pgsteal_kswapd_rate;    // 每秒 kswapd 回收页数
+    unsigned long oom_kill;        // 采集间隔内的 OOM kill 次数
+    int report_interval;           // 上报间隔（秒），服务端据此判断失联
     char machine_id[33];           // 机器ID
     char ip_address[INET6_ADDRSTRLEN]; // 本机IP地址
 } SystemInfo;
 
+// 启动时采集一次的静态信息，只在收到 SIGHUP 或网络地址变化时刷新
+typedef struct {
+    char system[128];                  // 系统信息
+    char machine_id[33];               // 机器ID
+    char ip_address[INET6_ADDRSTRLEN]; // 本机IP地址
+    int cpu_num_cores;                 // CPU核心数
+} StaticInfo;
+
 // 全局变量声明
 char g_server_name[64] = "未命名";
 char g_server_location[64] = "未知";
+StaticInfo g_static_info;
+// /proc 的挂载位置，容器中监控宿主机时可通过 ZSAN_PROC_ROOT 指定（如 /host/proc）
+char g_proc_root[256] = "/proc";
+// 统计磁盘容量时挂载点的前缀，容器中挂载宿主机根目录时通过 ZSAN_HOST_ROOT 指定（如 /host）
+char g_host_root[256] = "";
+static volatile sig_atomic_t g_reload_requested = 0;
+static int g_name_from_config = 0;     // 未通过环境变量设置，SIGHUP 时从配置文件重新读取
+static int g_location_from_config = 0;
+static int g_addr_monitor_fd = -1;
 
 // 函数声明 - 确保返回类型与定义匹配
 int get_connection_count(void);
 char *metrics_to_post_data(const SystemInfo *info);
 int send_post_request(const char *url, const char *data);
 void get_system_info(char *buffer, size_t size);
-int get_machine_id(char *buffer, size_t buffer_size);  // 修改为返回 int
+int get_machine_id(char *buffer, size_t buffer_size);  // 0: 系统 machine-id, 1: 已持久化的 ID, 2: 新生成的 ID
 void get_total_traffic(unsigned long *net_tx, unsigned long *net_rx);
+static void load_config_file(const char *path, int need_name, int need_location);
 void get_disk_usage(unsigned long *disks_total_kb, unsigned long *disks_avail_kb);
 void get_swap_info(double *swap_total, double *swap_free);
 int get_process_count(void);
@@ -191,42 +231,78 @@ void read_network_info(ProcResult *result) {
     }
 }
 
+// 拼接 /proc 下的路径
+static const char *proc_path(char *buf, size_t size, const char *name) {
+    snprintf(buf, size, "%s/%s", g_proc_root, name);
+    return buf;
+}
+
+// 读取并校验 32 位的 machine-id 文件
+static int read_machine_id_file(const char *path, char *buffer, size_t buffer_size) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    int ok = fgets(buffer, buffer_size, fp) != NULL;
+    fclose(fp);
+    if (!ok) return -1;
+    buffer[strcspn(buffer, "\r\n")] = '\0';
+    return strlen(buffer) == 32 ? 0 : -1;
+}
+
+// 生成随机 ID 并写入状态文件，之后每次启动读取同一个 ID
+static void generate_machine_id(char *buffer) {
+    unsigned char bytes[16];
+    int fd = open("/dev/urandom", O_RDONLY);
+    if (fd < 0 || read(fd, bytes, sizeof(bytes)) != sizeof(bytes)) {
+        srand(time(NULL) ^ getpid());
+        for (size_t i = 0; i < sizeof(bytes); i++) {
+            bytes[i] = rand() & 0xff;
+        }
+    }
+    if (fd >= 0) close(fd);
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        snprintf(buffer + i * 2, 3, "%02x", bytes[i]);
+    }
+
+    if (mkdir(STATE_DIR, 0755) != 0 && errno != EEXIST) {
+        log_message("WARN", "Failed to create %s: %s", STATE_DIR, strerror(errno));
+        return;
+    }
+    char temp_path[] = STATE_MACHINE_ID_FILE ".tmp";
+    FILE *fp = fopen(temp_path, "w");
+    if (!fp || fprintf(fp, "%s\n", buffer) < 0 || fclose(fp) != 0 ||
+        rename(temp_path, STATE_MACHINE_ID_FILE) != 0) {
+        log_message("WARN", "Failed to persist machine-id to %s: %s",
+                    STATE_MACHINE_ID_FILE, strerror(errno));
+    }
+}
+
 // 获取 Linux 服务器的 machine-id
 int get_machine_id(char *buffer, size_t buffer_size) {
     char *paths[] = {"/etc/machine-id", "/var/lib/dbus/machine-id", NULL};
     for (int i = 0; paths[i] != NULL; i++) {
-        FILE *fp = fopen(paths[i], "r");
-        if (fp) {
-            if (fgets(buffer, buffer_size, fp)) {
-                fclose(fp);
-                char *newline = strchr(buffer, '\n');
-                if (newline) *newline = '\0';
-                // 验证machine-id格式
-                if (strlen(buffer) == 32) {
-                    return 0; // 成功读取
-                }
-            }
-            fclose(fp);
+        if (read_machine_id_file(paths[i], buffer, buffer_size) == 0) {
+            return 0; // 成功读取
         }
     }
     
-    // 如果无法获取machine-id,生成一个随机ID
-    srand(time(NULL));
-    for (int i = 0; i < 32; i++) {
-        char c = "0123456789abcdef"[rand() % 16];
-        buffer[i] = c;
+    // 之前生成并持久化的ID
+    if (read_machine_id_file(STATE_MACHINE_ID_FILE, buffer, buffer_size) == 0) {
+        return 1;
     }
-    buffer[32] = '\0';
-    return 1; // 表示使用了随机生成的ID
+
+    // 如果无法获取machine-id,生成一个随机ID
+    generate_machine_id(buffer);
+    return 2; // 表示使用了新生成的ID
 }
 
 // 修改 get_total_traffic 函数
 void get_total_traffic(unsigned long *net_tx, unsigned long *net_rx) {
     FILE *fp;
     char line[256];
+    char path[PROC_PATH_MAX];
     *net_tx = 0;
     *net_rx = 0;
-    fp = fopen("/proc/net/dev", "r");
+    fp = fopen(proc_path(path, sizeof(path), "net/dev"), "r");
     if (!fp) {
         perror("Failed to open /proc/net/dev");
         return;
@@ -308,7 +384,8 @@ void get_disk_usage(unsigned long *disks_total_kb, unsigned long *disks_avail_kb
     struct mntent *mnt;
     struct statvfs vfs;
     unsigned long total_kb = 0, avail_kb = 0;
-    fp = setmntent("/proc/mounts", "r");
+    char path[PROC_PATH_MAX];
+    fp = setmntent(proc_path(path, sizeof(path), "mounts"), "r");
     if (!fp) {
         perror("Failed to open /proc/mounts");
         *disks_total_kb = *disks_avail_kb = 0;
@@ -319,7 +396,9 @@ void get_disk_usage(unsigned long *disks_total_kb, unsigned long *disks_avail_kb
             strncmp(mnt->mnt_fsname, "/dev/loop", 9) != 0 &&
             strncmp(mnt->mnt_fsname, "/dev/ram", 8) != 0 &&
             strncmp(mnt->mnt_fsname, "/dev/dm-", 8) != 0) {
-            if (statvfs(mnt->mnt_dir, &vfs) == 0) {
+            char mount_point[PROC_PATH_MAX];
+            snprintf(mount_point, sizeof(mount_point), "%s%s", g_host_root, mnt->mnt_dir);
+            if (statvfs(mount_point, &vfs) == 0) {
                 unsigned long block_size = vfs.f_frsize / 1024;
                 total_kb += vfs.f_blocks * block_size;
                 avail_kb += vfs.f_bavail * block_size;
@@ -358,7 +437,8 @@ void get_system_info(char *buffer, size_t size) {
 
 // 获取交换分区信息
 void get_swap_info(double *swap_total, double *swap_free) {
-    FILE *fp = fopen("/proc/meminfo", "r");
+    char path[PROC_PATH_MAX];
+    FILE *fp = fopen(proc_path(path, sizeof(path), "meminfo"), "r");
     if (!fp) {
         *swap_total = 0;
         *swap_free = 0;
@@ -379,7 +459,7 @@ void get_swap_info(double *swap_total, double *swap_free) {
 
 // 获取进程数
 int get_process_count() {
-    DIR *dir = opendir("/proc");
+    DIR *dir = opendir(g_proc_root);
     if (!dir) return 0;
     
     int count = 0;
@@ -400,9 +480,10 @@ int get_connection_count() {
     int count = 0;
     FILE *fp;
     char line[256];
+    char path[PROC_PATH_MAX];
     
     // 统计 TCP 连接
-    fp = fopen("/proc/net/tcp", "r");
+    fp = fopen(proc_path(path, sizeof(path), "net/tcp"), "r");
     if (fp) {
         while (fgets(line, sizeof(line), fp)) {
             if (strstr(line, ":") != NULL) count++;
@@ -411,7 +492,7 @@ int get_connection_count() {
     }
     
     // 统计 TCP6 连接
-    fp = fopen("/proc/net/tcp6", "r");
+    fp = fopen(proc_path(path, sizeof(path), "net/tcp6"), "r");
     if (fp) {
         while (fgets(line, sizeof(line), fp)) {
             if (strstr(line, ":") != NULL) count++;
@@ -470,6 +551,211 @@ char* get_local_ip() {
     return NULL;
 }
 
+// /proc/vmstat 中需要的键，下标与 VMSTAT_* 一致
+enum {
+    VMSTAT_PGMAJFAULT,
+    VMSTAT_PSWPIN,
+    VMSTAT_PSWPOUT,
+    VMSTAT_PGSCAN_DIRECT,
+    VMSTAT_PGSCAN_KSWAPD,
+    VMSTAT_PGSTEAL_DIRECT,
+    VMSTAT_PGSTEAL_KSWAPD,
+    VMSTAT_OOM_KILL,
+    VMSTAT_NR_DIRTY,
+    VMSTAT_NR_WRITEBACK,
+    VMSTAT_KEY_COUNT
+};
+
+#define VMSTAT_KEY(name) {name, sizeof(name) - 1}
+static const struct {
+    const char *name;
+    size_t len;
+} g_vmstat_keys[VMSTAT_KEY_COUNT] = {
+    VMSTAT_KEY("pgmajfault"),
+    VMSTAT_KEY("pswpin"),
+    VMSTAT_KEY("pswpout"),
+    VMSTAT_KEY("pgscan_direct"),
+    VMSTAT_KEY("pgscan_kswapd"),
+    VMSTAT_KEY("pgsteal_direct"),
+    VMSTAT_KEY("pgsteal_kswapd"),
+    VMSTAT_KEY("oom_kill"),
+    VMSTAT_KEY("nr_dirty"),
+    VMSTAT_KEY("nr_writeback")
+};
+
+// 解析 /proc/vmstat 内容，只匹配需要的键，全部找到后提前结束
+void parse_vmstat(const char *buf, size_t len, unsigned long long *values) {
+    const char *p = buf, *end = buf + len;
+    int remaining = VMSTAT_KEY_COUNT;
+    memset(values, 0, sizeof(unsigned long long) * VMSTAT_KEY_COUNT);
+    while (p < end && remaining > 0) {
+        const char *space = memchr(p, ' ', end - p);
+        if (!space) break;
+        size_t key_len = space - p;
+        for (int i = 0; i < VMSTAT_KEY_COUNT; i++) {
+            if (g_vmstat_keys[i].len == key_len && memcmp(p, g_vmstat_keys[i].name, key_len) == 0) {
+                values[i] = strtoull(space + 1, NULL, 10);
+                remaining--;
+                break;
+            }
+        }
+        const char *newline = memchr(space, '\n', end - space);
+        if (!newline) break;
+        p = newline + 1;
+    }
+}
+
+// 读取 /proc/vmstat 并计算每秒速率；文件描述符只打开一次，之后用 pread 从头读取
+static int g_vmstat_fd = -1;
+
+void get_vmstat_info(SystemInfo *info) {
+    static char buf[16384];
+    static unsigned long long prev[VMSTAT_KEY_COUNT];
+    static struct timespec prev_ts;
+    static int has_prev = 0;
+
+    if (g_vmstat_fd < 0) {
+        char path[PROC_PATH_MAX];
+        g_vmstat_fd = open(proc_path(path, sizeof(path), "vmstat"), O_RDONLY | O_CLOEXEC);
+        if (g_vmstat_fd < 0) return;
+    }
+
+    size_t len = 0;
+    ssize_t n;
+    while (len < sizeof(buf) && (n = pread(g_vmstat_fd, buf + len, sizeof(buf) - len, len)) > 0) {
+        len += n;
+    }
+    if (len == 0) return;
+
+    unsigned long long values[VMSTAT_KEY_COUNT];
+    parse_vmstat(buf, len, values);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    // 脏页和回写页是当前值，转换为 MB
+    static long page_size = 0;
+    if (page_size == 0) page_size = sysconf(_SC_PAGESIZE);
+    info->mem_dirty = values[VMSTAT_NR_DIRTY] * page_size / (1024.0 * 1024.0);
+    info->mem_writeback = values[VMSTAT_NR_WRITEBACK] * page_size / (1024.0 * 1024.0);
+
+    // 计数器按两次采集的间隔计算速率，第一次采集为 0
+    if (has_prev) {
+        double elapsed = (now.tv_sec - prev_ts.tv_sec) + (now.tv_nsec - prev_ts.tv_nsec) / 1e9;
+        #define VMSTAT_RATE(index) \
+            (elapsed > 0 && values[index] >= prev[index] ? (values[index] - prev[index]) / elapsed : 0)
+        info->pgmajfault_rate = VMSTAT_RATE(VMSTAT_PGMAJFAULT);
+        info->pswpin_rate = VMSTAT_RATE(VMSTAT_PSWPIN);
+        info->pswpout_rate = VMSTAT_RATE(VMSTAT_PSWPOUT);
+        info->pgscan_direct_rate = VMSTAT_RATE(VMSTAT_PGSCAN_DIRECT);
+        info->pgscan_kswapd_rate = VMSTAT_RATE(VMSTAT_PGSCAN_KSWAPD);
+        info->pgsteal_direct_rate = VMSTAT_RATE(VMSTAT_PGSTEAL_DIRECT);
+        info->pgsteal_kswapd_rate = VMSTAT_RATE(VMSTAT_PGSTEAL_KSWAPD);
+        #undef VMSTAT_RATE
+        // OOM kill 很少发生，直接上报间隔内的次数
+        if (values[VMSTAT_OOM_KILL] >= prev[VMSTAT_OOM_KILL]) {
+            info->oom_kill = values[VMSTAT_OOM_KILL] - prev[VMSTAT_OOM_KILL];
+        }
+    }
+    memcpy(prev, values, sizeof(prev));
+    prev_ts = now;
+    has_prev = 1;
+}
+
+// 刷新本机IP地址
+static void refresh_local_ip(StaticInfo *si) {
+    char *local_ip = get_local_ip();
+    snprintf(si->ip_address, sizeof(si->ip_address), "%s", local_ip ? local_ip : "unknown");
+}
+
+// 采集静态信息：系统版本、machine-id、IP地址、CPU核心数
+void load_static_info(StaticInfo *si) {
+    get_system_info(si->system, sizeof(si->system));
+    si->cpu_num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    refresh_local_ip(si);
+
+    int machine_id_status = get_machine_id(si->machine_id, sizeof(si->machine_id));
+    if (machine_id_status == 1) {
+        log_message("INFO", "Using persisted machine-id from %s", STATE_MACHINE_ID_FILE);
+    } else if (machine_id_status == 2) {
+        log_message("WARN", "Generated new machine-id %s", si->machine_id);
+    }
+}
+
+static void handle_sighup(int sig) {
+    (void)sig;
+    g_reload_requested = 1;
+}
+
+// 订阅内核的地址变化通知，失败时只依赖 SIGHUP 刷新
+static int open_addr_monitor(void) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) return -1;
+    struct sockaddr_nl addr = {0};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 读空通知队列，返回是否有地址变化；队列溢出时也视为有变化
+static int addr_changed(int fd) {
+    char buf[8192];
+    int changed = 0;
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+        int len = (int)n;
+        for (struct nlmsghdr *nh = (struct nlmsghdr *)buf; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+            if (nh->nlmsg_type == RTM_NEWADDR || nh->nlmsg_type == RTM_DELADDR) {
+                changed = 1;
+            }
+        }
+    }
+    if (n < 0 && errno == ENOBUFS) changed = 1;
+    return changed;
+}
+
+// 每次采集前检查刷新事件
+static void refresh_static_info_if_needed(void) {
+    if (g_reload_requested) {
+        g_reload_requested = 0;
+        load_static_info(&g_static_info);
+        if (g_name_from_config || g_location_from_config) {
+            load_config_file(CONFIG_FILE, g_name_from_config, g_location_from_config);
+        }
+        log_message("INFO", "Static info reloaded (SIGHUP)");
+    } else if (g_addr_monitor_fd >= 0 && addr_changed(g_addr_monitor_fd)) {
+        refresh_local_ip(&g_static_info);
+        log_message("INFO", "Network address changed, IP: %s", g_static_info.ip_address);
+    }
+}
+
+// 读取内存信息
+void get_mem_info(SystemInfo *info) {
+    char path[PROC_PATH_MAX];
+    FILE *fp = fopen(proc_path(path, sizeof(path), "meminfo"), "r");
+    if (fp) {
+        char line[256];
+        unsigned long long mem_total = 0, mem_free = 0, mem_available = 0;
+        unsigned long long mem_buffers = 0, mem_cached = 0;
+        while (fgets(line, sizeof(line), fp)) {
+            if (sscanf(line, "MemTotal: %llu kB", &mem_total) == 1) continue;
+            if (sscanf(line, "MemFree: %llu kB", &mem_free) == 1) continue;
+            if (sscanf(line, "MemAvailable: %llu kB", &mem_available) == 1) continue;
+            if (sscanf(line, "Buffers: %llu kB", &mem_buffers) == 1) continue;
+            if (sscanf(line, "Cached: %llu kB", &mem_cached) == 1) continue;
+        }
+        fclose(fp);
+        
+        info->mem_total = mem_total / 1024.0;  // 转换为 MB
+        info->mem_free = mem_free / 1024.0;
+        info->mem_used = (mem_total - mem_available) / 1024.0;
+        info->mem_buff_cache = (mem_buffers + mem_cached) / 1024.0;
+    }
+}
+
 // 获取所有监控数据
 void collect_metrics(SystemInfo *info) {
     struct sysinfo si;
@@ -479,10 +765,10 @@ void collect_metrics(SystemInfo *info) {
     
     get_total_traffic(&info->net_tx, &info->net_rx);
     get_disk_usage(&info->disks_total_kb, &info->disks_avail_kb);
-    info->cpu_num_cores = sysconf(_SC_NPROCESSORS_ONLN);
     
     // 计算 CPU 使用率
-    FILE *fp = fopen("/proc/stat", "r");
+    char path[PROC_PATH_MAX];
+    FILE *fp = fopen(proc_path(path, sizeof(path), "stat"), "r");
     if (fp) {
         char line[256];
         if (fgets(line, sizeof(line), fp)) {
@@ -496,7 +782,8 @@ void collect_metrics(SystemInfo *info) {
             static unsigned long prev_total = 0;
             static unsigned long prev_idle = 0;
             
-            if (prev_total > 0) {
+            // 计数器没有变化（两次采集间隔过短或读取的是静态样本）时不计算，避免 0/0
+            if (prev_total > 0 && total > prev_total) {
                 unsigned long total_diff = total - prev_total;
                 unsigned long idle_diff = idle_total - prev_idle;
                 info->cpu_percent = ((total_diff - idle_diff) * 100.0) / total_diff;
@@ -510,42 +797,17 @@ void collect_metrics(SystemInfo *info) {
         fclose(fp);
     }
     
-    // 读取内存信息
-    fp = fopen("/proc/meminfo", "r");
-    if (fp) {
-        char line[256];
-        unsigned long long mem_total = 0, mem_free = 0, mem_available = 0;
-        while (fgets(line, sizeof(line), fp)) {
-            if (sscanf(line, "MemTotal: %llu kB", &mem_total) == 1) continue;
-            if (sscanf(line, "MemFree: %llu kB", &mem_free) == 1) continue;
-            if (sscanf(line, "MemAvailable: %llu kB", &mem_available) == 1) continue;
-        }
-        fclose(fp);
-        
-        info->mem_total = mem_total / 1024.0;  // 转换为 MB
-        info->mem_free = mem_free / 1024.0;
-        info->mem_used = (mem_total - mem_available) / 1024.0;
-    }
-    
+    get_mem_info(info);
     get_swap_info(&info->swap_total, &info->swap_free);
+    get_vmstat_info(info);
     info->process_count = get_process_count();
     info->connection_count = get_connection_count();
-    get_system_info(info->system, sizeof(info->system));
-    
-    // 获取machine-id
-    int machine_id_status = get_machine_id(info->machine_id, sizeof(info->machine_id));
-    if (machine_id_status != 0) {
-        fprintf(stderr, "Warning: Using randomly generated machine-id\n");
-    }
     
-    // 获取本机IP地址
-    char *local_ip = get_local_ip();
-    if (local_ip) {
-        strncpy(info->ip_address, local_ip, sizeof(info->ip_address) - 1);
-        info->ip_address[sizeof(info->ip_address) - 1] = '\0';
-    } else {
-        strncpy(info->ip_address, "unknown", sizeof(info->ip_address) - 1);
-    }
+    // 静态信息在启动时采集，这里只复制
+    info->cpu_num_cores = g_static_info.cpu_num_cores;
+    snprintf(info->system, sizeof(info->system), "%s", g_static_info.system);
+    snprintf(info->machine_id, sizeof(info->machine_id), "%s", g_static_info.machine_id);
+    snprintf(info->ip_address, sizeof(info->ip_address), "%s", g_static_info.ip_address);
 }
 
 // 将 metrics_to_post_data 函数移到 main 函数之前
@@ -575,7 +837,19 @@ char *metrics_to_post_data(const SystemInfo *info) {
         "swap_total=%.1f&"
         "swap_free=%.1f&"
         "process_count=%d&"
-        "connection_count=%d",
+        "connection_count=%d&"
+        "mem_buff_cache=%.1f&"
+        "mem_dirty=%.1f&"
+        "mem_writeback=%.1f&"
+        "pgmajfault_rate=%.2f&"
+        "pswpin_rate=%.2f&"
+        "pswpout_rate=%.2f&"
+        "pgscan_direct_rate=%.2f&"
+        "pgscan_kswapd_rate=%.2f&"
+        "pgsteal_direct_rate=%.2f&"
+        "pgsteal_kswapd_rate=%.2f&"
+        "oom_kill=%lu&"
+        "report_interval=%d",
         info->machine_id,
         g_server_name,
         info->system,
@@ -594,7 +868,19 @@ char *metrics_to_post_data(const SystemInfo *info) {
         info->swap_total,
         info->swap_free,
         info->process_count,
-        info->connection_count
+        info->connection_count,
+        info->mem_buff_cache,
+        info->mem_dirty,
+        info->mem_writeback,
+        info->pgmajfault_rate,
+        info->pswpin_rate,
+        info->pswpout_rate,
+        info->pgscan_direct_rate,
+        info->pgscan_kswapd_rate,
+        info->pgsteal_direct_rate,
+        info->pgsteal_kswapd_rate,
+        info->oom_kill,
+        info->report_interval
     );
     
     return data;
@@ -747,6 +1033,47 @@ static void safe_strncpy(char *dest, const char *src, size_t size) {
 }
 
 // main 函数和其他代码保持不变
+// 解析配置行的值，去掉换行和两端引号
+static void parse_config_value(const char *value, char *dest, size_t size) {
+    char buf[256];
+    safe_strncpy(buf, value, sizeof(buf));
+    buf[strcspn(buf, "\r\n")] = '\0';
+    char *start = buf;
+    if (*start == '"') start++;
+    size_t len = strlen(start);
+    if (len > 0 && start[len - 1] == '"') start[len - 1] = '\0';
+    safe_strncpy(dest, start, size);
+}
+
+// 等待一个上报间隔；nanosleep 不受 SA_RESTART 影响，被信号打断时按精确的剩余时间继续等待
+static void sleep_interval(unsigned int seconds) {
+    struct timespec remaining = {seconds, 0};
+    while (nanosleep(&remaining, &remaining) == -1 && errno == EINTR) {
+    }
+}
+
+// 一次读取配置文件中的 SERVER_NAME 和 SERVER_LOCATION
+static void load_config_file(const char *path, int need_name, int need_location) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        printf("Config file %s not found\n", path);
+        return;
+    }
+    char line[256];
+    while ((need_name || need_location) && fgets(line, sizeof(line), fp)) {
+        if (need_name && strncmp(line, "SERVER_NAME=", 12) == 0) {
+            parse_config_value(line + 12, g_server_name, sizeof(g_server_name));
+            printf("Server name from config: %s\n", g_server_name);
+            need_name = 0;
+        } else if (need_location && strncmp(line, "SERVER_LOCATION=", 16) == 0) {
+            parse_config_value(line + 16, g_server_location, sizeof(g_server_location));
+            printf("Server location from config: %s\n", g_server_location);
+            need_location = 0;
+        }
+    }
+    fclose(fp);
+}
+
 int main(int argc, char *argv[]) {
     // 检查日志文件权限
     FILE *test_log = fopen("/var/log/zsan/zsan.log", "a");
@@ -766,64 +1093,31 @@ int main(int argc, char *argv[]) {
     char url[256] = "";
     int opt;
     
-    // 从环境变量读取服务器名称和位置
+    // 从环境变量读取服务器名称和位置，缺少的再从配置文件读取
     char *env_name = getenv("SERVER_NAME");
     char *env_location = getenv("SERVER_LOCATION");
     
-    // 打印所有环境变量用于调试
-    extern char **environ;
-    printf("Environment variables:\n");
-    for (char **env = environ; *env != NULL; env++) {
-        printf("%s\n", *env);
-    }
-    
-    // 确保环境变量被正确读取
     if (env_name) {
         safe_strncpy(g_server_name, env_name, sizeof(g_server_name));
         printf("Server name from env: %s\n", g_server_name);
-    } else {
-        printf("SERVER_NAME environment variable not found\n");
-        FILE *fp = fopen("/root/.kunlun/config", "r");
-        if (fp) {
-            char line[256];
-            while (fgets(line, sizeof(line), fp)) {
-                if (strncmp(line, "SERVER_NAME=", 12) == 0) {
-                    char *value = line + 12;
-                    if (value[0] == '"') value++;
-                    size_t len = strlen(value);
-                    if (len > 0 && value[len-1] == '\n') value[len-1] = '\0';
-                    if (len > 1 && value[len-2] == '"') value[len-2] = '\0';
-                    safe_strncpy(g_server_name, value, sizeof(g_server_name));
-                    printf("Server name from config: %s\n", g_server_name);
-                    break;
-                }
-            }
-            fclose(fp);
-        }
     }
-    
     if (env_location) {
         safe_strncpy(g_server_location, env_location, sizeof(g_server_location));
         printf("Server location from env: %s\n", g_server_location);
-    } else {
-        printf("SERVER_LOCATION environment variable not found\n");
-        FILE *fp = fopen("/root/.kunlun/config", "r");
-        if (fp) {
-            char line[256];
-            while (fgets(line, sizeof(line), fp)) {
-                if (strncmp(line, "SERVER_LOCATION=", 15) == 0) {
-                    char *value = line + 15;
-                    if (value[0] == '"') value++;
-                    size_t len = strlen(value);
-                    if (len > 0 && value[len-1] == '\n') value[len-1] = '\0';
-                    if (len > 1 && value[len-2] == '"') value[len-2] = '\0';
-                    safe_strncpy(g_server_location, value, sizeof(g_server_location));
-                    printf("Server location from config: %s\n", g_server_location);
-                    break;
-                }
-            }
-            fclose(fp);
-        }
+    }
+    g_name_from_config = !env_name;
+    g_location_from_config = !env_location;
+    if (g_name_from_config || g_location_from_config) {
+        load_config_file(CONFIG_FILE, g_name_from_config, g_location_from_config);
+    }
+    
+    char *env_proc_root = getenv("ZSAN_PROC_ROOT");
+    if (env_proc_root) {
+        safe_strncpy(g_proc_root, env_proc_root, sizeof(g_proc_root));
+    }
+    char *env_host_root = getenv("ZSAN_HOST_ROOT");
+    if (env_host_root) {
+        safe_strncpy(g_host_root, env_host_root, sizeof(g_host_root));
     }
     
     while ((opt = getopt(argc, argv, "s:u:")) != -1) {
@@ -848,13 +1142,32 @@ int main(int argc, char *argv[]) {
     log_message("INFO", "zsan client starting up...");
     log_message("INFO", "Version: 0.0.1");
     
+    // 静态信息只在启动时采集一次
+    load_static_info(&g_static_info);
+    log_message("INFO", "Machine ID: %s, system: %s, IP: %s, cores: %d",
+                g_static_info.machine_id, g_static_info.system,
+                g_static_info.ip_address, g_static_info.cpu_num_cores);
+    
+    // SIGHUP 或网络地址变化时刷新静态信息
+    struct sigaction sa = {0};
+    sa.sa_handler = handle_sighup;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGHUP, &sa, NULL);
+    g_addr_monitor_fd = open_addr_monitor();
+    if (g_addr_monitor_fd < 0) {
+        log_message("WARN", "Netlink address monitor unavailable, IP refreshes on SIGHUP only");
+    }
+    
     while (1) {
+        refresh_static_info_if_needed();
         SystemInfo info = {0};
         collect_metrics(&info);
+        info.report_interval = interval;
         char *post_data = metrics_to_post_data(&info);
         if (!post_data) {
             log_message("ERROR", "Failed to prepare POST data");
-            sleep(interval);
+            sleep_interval(interval);
             continue;
         }
         
@@ -864,7 +1177,7 @@ int main(int argc, char *argv[]) {
         }
         
         free(post_data);
-        sleep(interval);
+        sleep_interval(interval);
     }
     return 0;
 }
@@ -188,6 +188,7 @@ After=network.target
 [Service]
 Type=simple
 ExecStart=/opt/zsan/bin/zsan_amd64 -s $INTERVAL -u $REPORT_URL
+ExecReload=/bin/kill -HUP \$MAINPID
 Environment=SERVER_NAME=$SERVER_NAME
 Environment=HOME=/root
 Environment=PATH=/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin
@@ -289,10 +290,12 @@ uninstall_zsan() {
         rm -rf /opt/zsan
         rm -rf /etc/zsan
         rm -rf /var/log/zsan
+        rm -rf /var/lib/zsan
     else
         sudo rm -rf /opt/zsan
         sudo rm -rf /etc/zsan
         sudo rm -rf /var/log/zsan
+        sudo rm -rf /var/lib/zsan
     fi
 
     log "zsan 已成功卸载！"